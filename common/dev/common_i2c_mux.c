@@ -27,14 +27,8 @@ bool set_mux_channel(mux_config mux_cfg)
 	int status = 0;
 	int retry = 5;
 
-	/* Set channel */
-	I2C_MSG mux_msg = { 0 };
-	mux_msg.bus = mux_cfg.bus;
-	mux_msg.target_addr = mux_cfg.target_addr;
-	mux_msg.tx_len = 1;
-	mux_msg.data[0] = mux_cfg.channel;
-
-	status = i2c_master_write(&mux_msg, retry);
+	/* Set channel, skipped if the channel is selected already */
+	status = i2c_master_write_mux(mux_cfg.bus, mux_cfg.target_addr, mux_cfg.channel, retry);
 	if (status != 0) {
 		LOG_ERR("set channel fail, status: %d, bus: %d, addr: 0x%x", status, mux_cfg.bus,
 			mux_cfg.target_addr);
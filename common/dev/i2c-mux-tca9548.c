@@ -38,15 +38,9 @@ bool tca9548_select_chan(uint8_t sensor_num, void *args)
 	struct tca9548 *p = (struct tca9548 *)args;
 
 	uint8_t retry = 5;
-	I2C_MSG msg = { 0 };
 
-	msg.bus = cfg->port;
-	/* change address to 7-bit */
-	msg.target_addr = ((p->addr) >> 1);
-	msg.tx_len = 1;
-	msg.data[0] = (1 << (p->chan));
-
-	if (i2c_master_write(&msg, retry)) {
+	/* change address to 7-bit, skip the write if the channel is selected already */
+	if (i2c_master_write_mux(cfg->port, ((p->addr) >> 1), (1 << (p->chan)), retry)) {
 		LOG_ERR("I2C master write failed");
 		return false;
 	}
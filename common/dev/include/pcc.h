@@ -22,6 +22,8 @@
 #define PCC_STACK_SIZE 512
 #define PCC_BUFFER_LEN 1024
 #define PROCESS_POSTCODE_STACK_SIZE 2048
+/* Max 4-byte post codes in one message to BMC, fits in the BMC IPMB receive buffer */
+#define PCC_POSTCODE_BATCH_MAX 48
 
 uint16_t copy_pcc_read_buffer(uint16_t start, uint16_t length, uint8_t *buffer,
 			      uint16_t buffer_len);
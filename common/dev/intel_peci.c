@@ -23,6 +23,7 @@
 #include "libutil.h"
 #include "intel_peci.h"
 #include "ipmi.h"
+#include "ipmi_msg_pool.h"
 #include "util_sys.h"
 #include "intel_dimm.h"
 #include <logging/log.h>
@@ -89,7 +90,7 @@ bool check_dimm_present(uint8_t dimm_channel, uint8_t dimm_num, uint8_t *present
 		return false;
 	}
 
-	ipmi_msg *dimm_msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+	ipmi_msg *dimm_msg = (ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 	if (dimm_msg == NULL) {
 		LOG_ERR("Fail to allocate DIMM message memory");
 		return false;
@@ -100,7 +101,7 @@ bool check_dimm_present(uint8_t dimm_channel, uint8_t dimm_num, uint8_t *present
 		(get_cpu_memory_temp_req *)malloc(sizeof(get_cpu_memory_temp_req));
 	if (get_dimm_temp_req == NULL) {
 		LOG_ERR("Fail to allocate request array memory");
-		SAFE_FREE(dimm_msg);
+		SAFE_IPMI_MSG_FREE(dimm_msg);
 		return false;
 	}
 	memset(get_dimm_temp_req, 0, sizeof(get_cpu_memory_temp_req));
@@ -204,7 +205,7 @@ bool check_dimm_present(uint8_t dimm_channel, uint8_t dimm_num, uint8_t *present
 	ret = true;
 
 safe_free:
-	SAFE_FREE(dimm_msg);
+	SAFE_IPMI_MSG_FREE(dimm_msg);
 	SAFE_FREE(get_dimm_temp_req);
 	return ret;
 }
@@ -22,6 +22,7 @@
 #include <drivers/misc/aspeed/pcc_aspeed.h>
 #include "ipmb.h"
 #include "ipmi.h"
+#include "ipmi_msg_pool.h"
 #include "libutil.h"
 #include "pcc.h"
 #include <logging/log.h>
@@ -149,7 +150,7 @@ void check_ABL_error(uint32_t postcode)
 	}
 
 	ipmb_error status;
-	ipmi_msg *msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+	ipmi_msg *msg = (ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 	if (msg == NULL) {
 		LOG_ERR("Memory allocation failed.");
 		return;
@@ -183,53 +184,69 @@ void check_ABL_error(uint32_t postcode)
 	if (status != IPMB_ERROR_SUCCESS) {
 		LOG_ERR("Failed to record ABL SEL, post code 0x%08x, ret %d", postcode, status);
 	}
-	SAFE_FREE(msg);
+	SAFE_IPMI_MSG_FREE(msg);
 }
 
+/* Forward post codes to BMC in batches of up to PCC_POSTCODE_BATCH_MAX codes per message. The
+ * requests are queued without waiting for BMC's response, so forwarding keeps up with the host
+ * during boot flows which emit thousands of PSB/ABL codes.
+ */
 static void process_postcode(void *arvg0, void *arvg1, void *arvg2)
 {
 	uint16_t send_index = 0;
 	while (1) {
 		k_sem_take(&get_postcode_sem, K_FOREVER);
-		ipmi_msg *msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+		ipmi_msg *msg = (ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 		if (msg == NULL) {
 			LOG_ERR("Memory allocation failed.");
 			continue;
 		}
 
 		uint16_t current_read_index = pcc_read_index;
-		for (; send_index != current_read_index; send_index++) {
-			if (send_index == PCC_BUFFER_LEN - 1) {
-				send_index = 0;
-			}
-			if (((pcc_read_buffer[send_index] >> 24) & 0xFF) == PSB_POSTCODE_PREFIX) {
-				check_PSB_error(pcc_read_buffer[send_index]);
-			} else if (((pcc_read_buffer[send_index] >> 24) & 0xFF) ==
-				   ABL_POSTCODE_PREFIX) {
-				check_ABL_error(pcc_read_buffer[send_index]);
-			}
+		while (send_index != current_read_index) {
+			uint8_t count = 0;
 
 			memset(msg, 0, sizeof(ipmi_msg));
 			msg->InF_source = SELF;
 			msg->InF_target = BMC_IPMB;
 			msg->netfn = NETFN_OEM_1S_REQ;
 			msg->cmd = CMD_OEM_1S_SEND_4BYTE_POST_CODE_TO_BMC;
-			msg->data_len = 8;
 			msg->data[0] = IANA_ID & 0xFF;
 			msg->data[1] = (IANA_ID >> 8) & 0xFF;
 			msg->data[2] = (IANA_ID >> 16) & 0xFF;
-			msg->data[3] = 4;
-			msg->data[4] = pcc_read_buffer[send_index] & 0xFF;
-			msg->data[5] = (pcc_read_buffer[send_index] >> 8) & 0xFF;
-			msg->data[6] = (pcc_read_buffer[send_index] >> 16) & 0xFF;
-			msg->data[7] = (pcc_read_buffer[send_index] >> 24) & 0xFF;
-			ipmb_error status = ipmb_read(msg, IPMB_inf_index_map[msg->InF_target]);
+
+			for (; (send_index != current_read_index) &&
+			       (count < PCC_POSTCODE_BATCH_MAX);
+			     count++) {
+				uint32_t postcode = pcc_read_buffer[send_index];
+				if (((postcode >> 24) & 0xFF) == PSB_POSTCODE_PREFIX) {
+					check_PSB_error(postcode);
+				} else if (((postcode >> 24) & 0xFF) == ABL_POSTCODE_PREFIX) {
+					check_ABL_error(postcode);
+				}
+
+				uint8_t *data = &msg->data[4 + (4 * count)];
+				data[0] = postcode & 0xFF;
+				data[1] = (postcode >> 8) & 0xFF;
+				data[2] = (postcode >> 16) & 0xFF;
+				data[3] = (postcode >> 24) & 0xFF;
+
+				send_index++;
+				if (send_index == PCC_BUFFER_LEN) {
+					send_index = 0;
+				}
+			}
+
+			msg->data[3] = 4 * count;
+			msg->data_len = 4 + msg->data[3];
+			ipmb_error status =
+				ipmb_send_request(msg, IPMB_inf_index_map[msg->InF_target]);
 			if (status != IPMB_ERROR_SUCCESS) {
-				LOG_ERR("Failed to send 4-byte post code to BMC, status %d.", status);
+				LOG_ERR("Failed to send %d 4-byte post codes to BMC, status %d.",
+					count, status);
 			}
-			k_yield();
 		}
-		SAFE_FREE(msg)
+		SAFE_IPMI_MSG_FREE(msg)
 	}
 }
 
@@ -19,6 +19,7 @@
 #include "sensor.h"
 #include "libutil.h"
 #include "ipmi.h"
+#include "ipmi_msg_pool.h"
 #include "plat_ipmb.h"
 #include <logging/log.h>
 
@@ -34,7 +35,7 @@ uint8_t pch_read(uint8_t sensor_num, int *reading)
 #if MAX_IPMB_IDX
 	ipmb_error status;
 	ipmi_msg *bridge_msg;
-	bridge_msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+	bridge_msg = (ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 	if (bridge_msg == NULL) {
 		LOG_ERR("pch_read bridge message alloc fail");
 		return SENSOR_UNSPECIFIED_ERROR;
@@ -55,7 +56,7 @@ uint8_t pch_read(uint8_t sensor_num, int *reading)
 		status = ipmb_read(bridge_msg, IPMB_inf_index_map[bridge_msg->InF_target]);
 		if (status != IPMB_ERROR_SUCCESS) {
 			LOG_ERR("pch_read ipmb read fail, ret %d", status);
-			SAFE_FREE(bridge_msg);
+			SAFE_IPMI_MSG_FREE(bridge_msg);
 			return SENSOR_FAIL_TO_ACCESS;
 		}
 
@@ -73,18 +74,18 @@ uint8_t pch_read(uint8_t sensor_num, int *reading)
 			sensor_val *sval = (sensor_val *)reading;
 			memset(sval, 0, sizeof(sensor_val));
 			sval->integer = bridge_msg->data[0];
-			SAFE_FREE(bridge_msg);
+			SAFE_IPMI_MSG_FREE(bridge_msg);
 			return SENSOR_READ_SUCCESS;
 		} else if (bridge_msg->completion_code == CC_NODE_BUSY) {
 			continue;
 		} else {
-			SAFE_FREE(bridge_msg);
+			SAFE_IPMI_MSG_FREE(bridge_msg);
 			return SENSOR_UNSPECIFIED_ERROR;
 		}
 	}
 
 	LOG_ERR("pch_read retry read fail");
-	SAFE_FREE(bridge_msg);
+	SAFE_IPMI_MSG_FREE(bridge_msg);
 #endif
 	return SENSOR_UNSPECIFIED_ERROR;
 }
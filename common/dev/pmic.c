@@ -18,6 +18,7 @@
 #include <stdlib.h>
 #include "ipmb.h"
 #include "ipmi.h"
+#include "ipmi_msg_pool.h"
 #include "pmic.h"
 #include "sensor.h"
 #include "libutil.h"
@@ -73,7 +74,7 @@ int pmic_ipmb_transfer(int *total_pmic_power, uint8_t seq_source, uint8_t netFn,
 		return -1;
 	}
 
-	ipmi_msg *pmic_msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+	ipmi_msg *pmic_msg = (ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 	if (pmic_msg == NULL) {
 		LOG_ERR("Failed to allocate memory");
 		return -1;
@@ -87,13 +88,13 @@ int pmic_ipmb_transfer(int *total_pmic_power, uint8_t seq_source, uint8_t netFn,
 	if ((ret != IPMB_ERROR_SUCCESS) || (pmic_msg->completion_code != CC_SUCCESS)) {
 		LOG_ERR("Failed to send pmic_command ret: 0x%x CC: 0x%x", ret,
 			pmic_msg->completion_code);
-		SAFE_FREE(pmic_msg);
+		SAFE_IPMI_MSG_FREE(pmic_msg);
 		return -1;
 	}
 
 	if (pmic_msg->data_len < 4) {
 		LOG_DBG("pmic res data_len: 0x%x", pmic_msg->data_len);
-		SAFE_FREE(pmic_msg);
+		SAFE_IPMI_MSG_FREE(pmic_msg);
 		return -1;
 	}
 
@@ -101,7 +102,7 @@ int pmic_ipmb_transfer(int *total_pmic_power, uint8_t seq_source, uint8_t netFn,
 		*total_pmic_power = pmic_msg->data[3] * PMIC_TOTAL_POWER_MW;
 	}
 
-	SAFE_FREE(pmic_msg);
+	SAFE_IPMI_MSG_FREE(pmic_msg);
 	return 0;
 }
 
@@ -25,6 +25,7 @@
 #include "snoop.h"
 #include "libutil.h"
 #include "ipmi.h"
+#include "ipmi_msg_pool.h"
 #include "power_status.h"
 #include <logging/log.h>
 
@@ -160,7 +161,7 @@ void send_post_code_to_BMC()
 			return;
 		}
 		if (send_postcode_start_position != send_postcode_end_position) {
-			send_postcode_msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+			send_postcode_msg = (ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 			static uint8_t alloc_sendmsg_retry = 0;
 			if (send_postcode_msg == NULL) {
 				if (get_post_status()) {
@@ -202,7 +203,7 @@ void send_post_code_to_BMC()
 
 			status = ipmb_read(send_postcode_msg,
 					   IPMB_inf_index_map[send_postcode_msg->InF_target]);
-			SAFE_FREE(send_postcode_msg);
+			SAFE_IPMI_MSG_FREE(send_postcode_msg);
 			if (status == IPMB_ERROR_FAILURE) {
 				LOG_ERR("Fail to post msg to txqueue for send post code from %d to %d",
 				       send_postcode_start_position, send_postcode_end_position);
@@ -31,10 +31,190 @@ LOG_MODULE_REGISTER(hal_i2c);
 #define AST_1030_I2C_REG_LEN 0x80
 #define AST_1030_SLAVE_EN BIT(1)
 
+#define I2C_PMBUS_PAGE_CMD 0x00
+
+#ifndef I2C_ASYNC_WORKQ_MAX
+#define I2C_ASYNC_WORKQ_MAX I2C_ASYNC_WORKQ_MAX_DEFAULT
+#endif
+
+#define MAX_I2C_ASYNC_WORKQ_NAME_LEN 16
+
 static const struct device *dev_i2c[I2C_BUS_MAX_NUM];
 
 struct k_mutex i2c_mutex[I2C_BUS_MAX_NUM];
 
+/*
+ * Per-bus copy of the write phase of a write-read transfer, guarded by i2c_mutex. Read data
+ * lands in msg->data directly, so the write bytes must be kept apart from it for retries.
+ */
+static uint8_t i2c_txbuf[I2C_BUS_MAX_NUM][I2C_BUFF_SIZE];
+
+/*
+ * Transfers of threads between i2c_priority_enter() and i2c_priority_exit(), e.g. IPMI and PLDM
+ * handlers working for the BMC, go ahead of background transfers such as sensor polling. Each
+ * bus counts its pending priority transfers, and a background transfer which gets the bus while
+ * any of them is pending gives the bus up until they are done.
+ */
+typedef struct _i2c_priority_thread {
+	k_tid_t tid;
+	uint8_t depth;
+} i2c_priority_thread;
+
+static atomic_t i2c_priority_pending[I2C_BUS_MAX_NUM];
+static struct k_condvar i2c_priority_done[I2C_BUS_MAX_NUM];
+static i2c_priority_thread i2c_priority_threads[I2C_PRIORITY_THREAD_MAX];
+static struct k_spinlock i2c_priority_lock;
+
+/*
+ * Asynchronous transfers are queued per bus and priority, and each bus is drained back-to-back,
+ * highest priority first, by a work item on one of the I2C work queues (bus % I2C_ASYNC_WORKQ_MAX).
+ * Buses sharing a work queue wait for each other, platforms with many busy buses could define
+ * I2C_ASYNC_WORKQ_MAX.
+ */
+typedef struct _i2c_async_bus {
+	struct k_fifo fifo[I2C_ASYNC_PRIORITY_MAX];
+	struct k_work work;
+} i2c_async_bus;
+
+static i2c_async_bus i2c_async[I2C_BUS_MAX_NUM];
+static struct k_work_q i2c_async_work_q[I2C_ASYNC_WORKQ_MAX];
+K_THREAD_STACK_ARRAY_DEFINE(i2c_async_work_stack, I2C_ASYNC_WORKQ_MAX, I2C_ASYNC_STACK_SIZE);
+
+/*
+ * Last mux control byte and PMBus PAGE written per bus, guarded by i2c_mutex, so selects that
+ * would not change anything can be skipped. A bus is forgotten after any failed transfer and
+ * after a write to a mux, because devices behind different channels may share an address.
+ * Forgetting a bus bumps its generation atomically, so it's safe from ISRs and callers without
+ * i2c_mutex, an entry is only valid for the generation it was written in.
+ */
+enum I2C_SELECT_TYPE {
+	I2C_SELECT_MUX,
+	I2C_SELECT_PAGE,
+};
+
+typedef struct _i2c_select_state {
+	bool is_valid;
+	atomic_val_t gen;
+	uint8_t type;
+	uint8_t addr;
+	uint8_t value;
+} i2c_select_state;
+
+static i2c_select_state i2c_select_cache[I2C_BUS_MAX_NUM][I2C_SELECT_CACHE_SIZE];
+static uint8_t i2c_select_cache_next[I2C_BUS_MAX_NUM];
+static atomic_t i2c_select_cache_gen[I2C_BUS_MAX_NUM];
+
+/* Mark transfers of the current thread as priority ones, return -ENOSPC if the thread table is
+ * full and the transfers stay in background. i2c_priority_exit() is only needed on success.
+ */
+int i2c_priority_enter(void)
+{
+	k_tid_t tid = k_current_get();
+	i2c_priority_thread *free_slot = NULL;
+	k_spinlock_key_t key = k_spin_lock(&i2c_priority_lock);
+
+	for (uint8_t i = 0; i < I2C_PRIORITY_THREAD_MAX; i++) {
+		if (i2c_priority_threads[i].tid == tid) {
+			i2c_priority_threads[i].depth++;
+			k_spin_unlock(&i2c_priority_lock, key);
+			return 0;
+		}
+		if ((free_slot == NULL) && (i2c_priority_threads[i].tid == NULL)) {
+			free_slot = &i2c_priority_threads[i];
+		}
+	}
+
+	if (free_slot != NULL) {
+		free_slot->tid = tid;
+		free_slot->depth = 1;
+	}
+	k_spin_unlock(&i2c_priority_lock, key);
+
+	return (free_slot != NULL) ? 0 : -ENOSPC;
+}
+
+void i2c_priority_exit(void)
+{
+	k_tid_t tid = k_current_get();
+	k_spinlock_key_t key = k_spin_lock(&i2c_priority_lock);
+
+	for (uint8_t i = 0; i < I2C_PRIORITY_THREAD_MAX; i++) {
+		if (i2c_priority_threads[i].tid == tid) {
+			if (--i2c_priority_threads[i].depth == 0) {
+				i2c_priority_threads[i].tid = NULL;
+			}
+			break;
+		}
+	}
+	k_spin_unlock(&i2c_priority_lock, key);
+}
+
+static bool is_i2c_priority_thread(void)
+{
+	k_tid_t tid = k_current_get();
+	bool ret = false;
+	k_spinlock_key_t key = k_spin_lock(&i2c_priority_lock);
+
+	for (uint8_t i = 0; i < I2C_PRIORITY_THREAD_MAX; i++) {
+		if (i2c_priority_threads[i].tid == tid) {
+			ret = true;
+			break;
+		}
+	}
+	k_spin_unlock(&i2c_priority_lock, key);
+	return ret;
+}
+
+/* Called with i2c_mutex held, so a background transfer can't miss the wake up */
+static void i2c_priority_transfer_done(uint8_t bus)
+{
+	if (atomic_dec(&i2c_priority_pending[bus]) == 1) {
+		k_condvar_broadcast(&i2c_priority_done[bus]);
+	}
+}
+
+/* Take the bus for a transfer, return 0 on success */
+static int i2c_bus_lock(uint8_t bus, bool is_priority)
+{
+	int status;
+
+	if (is_priority) {
+		atomic_inc(&i2c_priority_pending[bus]);
+		status = k_mutex_lock(&i2c_mutex[bus], K_MSEC(I2C_BUS_LOCK_TIMEOUT_MS));
+		if (status) {
+			// Background transfers left waiting recheck at their timeout at the latest
+			atomic_dec(&i2c_priority_pending[bus]);
+			k_condvar_broadcast(&i2c_priority_done[bus]);
+		}
+		return status;
+	}
+
+	int64_t deadline = k_uptime_get() + I2C_BUS_LOCK_TIMEOUT_MS;
+	status = k_mutex_lock(&i2c_mutex[bus], K_MSEC(I2C_BUS_LOCK_TIMEOUT_MS));
+	if (status) {
+		return status;
+	}
+
+	while (atomic_get(&i2c_priority_pending[bus]) > 0) {
+		int64_t remain_ms = deadline - k_uptime_get();
+		if (remain_ms <= 0) {
+			k_mutex_unlock(&i2c_mutex[bus]);
+			return -EAGAIN;
+		}
+		k_condvar_wait(&i2c_priority_done[bus], &i2c_mutex[bus], K_MSEC(remain_ms));
+	}
+
+	return 0;
+}
+
+static int i2c_bus_unlock(uint8_t bus, bool is_priority)
+{
+	if (is_priority) {
+		i2c_priority_transfer_done(bus);
+	}
+	return k_mutex_unlock(&i2c_mutex[bus]);
+}
+
 int i2c_freq_set(uint8_t i2c_bus, uint8_t i2c_speed_mode, uint8_t en_slave)
 {
 	if (check_i2c_bus_valid(i2c_bus) < 0) {
@@ -58,6 +238,93 @@ int i2c_freq_set(uint8_t i2c_bus, uint8_t i2c_speed_mode, uint8_t en_slave)
 	return 0;
 }
 
+void i2c_select_cache_invalidate(uint8_t bus)
+{
+	if (bus >= I2C_BUS_MAX_NUM) {
+		return;
+	}
+
+	atomic_inc(&i2c_select_cache_gen[bus]);
+}
+
+void i2c_select_cache_invalidate_all(void)
+{
+	for (uint8_t bus = 0; bus < I2C_BUS_MAX_NUM; bus++) {
+		i2c_select_cache_invalidate(bus);
+	}
+}
+
+static bool is_i2c_select_state_valid(uint8_t bus, i2c_select_state *state)
+{
+	return state->is_valid && (state->gen == atomic_get(&i2c_select_cache_gen[bus]));
+}
+
+static i2c_select_state *find_i2c_select_state(uint8_t bus, uint8_t addr)
+{
+	for (uint8_t i = 0; i < I2C_SELECT_CACHE_SIZE; i++) {
+		if (is_i2c_select_state_valid(bus, &i2c_select_cache[bus][i]) &&
+		    (i2c_select_cache[bus][i].addr == addr)) {
+			return &i2c_select_cache[bus][i];
+		}
+	}
+	return NULL;
+}
+
+/* Remember the state written in generation gen, which is read before the write was started */
+static void update_i2c_select_state(uint8_t bus, uint8_t addr, uint8_t type, uint8_t value,
+				    atomic_val_t gen)
+{
+	i2c_select_state *state = find_i2c_select_state(bus, addr);
+
+	if (state == NULL) {
+		for (uint8_t i = 0; i < I2C_SELECT_CACHE_SIZE; i++) {
+			if (!is_i2c_select_state_valid(bus, &i2c_select_cache[bus][i])) {
+				state = &i2c_select_cache[bus][i];
+				break;
+			}
+		}
+	}
+
+	if (state == NULL) {
+		state = &i2c_select_cache[bus][i2c_select_cache_next[bus]];
+		i2c_select_cache_next[bus] =
+			(i2c_select_cache_next[bus] + 1) % I2C_SELECT_CACHE_SIZE;
+	}
+
+	state->type = type;
+	state->addr = addr;
+	state->value = value;
+	state->gen = gen;
+	state->is_valid = true;
+}
+
+/* Forget what a raw write may have changed, only a PAGE target keeps the rest of its bus */
+static void i2c_select_cache_write_notify(uint8_t bus, uint8_t addr)
+{
+	i2c_select_state *state = find_i2c_select_state(bus, addr);
+
+	if ((state != NULL) && (state->type == I2C_SELECT_PAGE)) {
+		state->is_valid = false;
+		return;
+	}
+
+	i2c_select_cache_invalidate(bus);
+}
+
+/* Forget what the write phase of a write-read may have selected. Register reads are the common
+ * case, so only a write to a known mux or a PAGE write drops cached state.
+ */
+static void i2c_select_cache_read_notify(uint8_t bus, uint8_t addr, uint8_t *tx, uint8_t tx_len)
+{
+	i2c_select_state *state = find_i2c_select_state(bus, addr);
+
+	if ((state != NULL) && (state->type == I2C_SELECT_MUX)) {
+		i2c_select_cache_invalidate(bus);
+	} else if ((state != NULL) && (tx_len >= 2) && (tx[0] == I2C_PMBUS_PAGE_CMD)) {
+		state->is_valid = false;
+	}
+}
+
 int i2c_master_read(I2C_MSG *msg, uint8_t retry)
 {
 	CHECK_NULL_ARG_WITH_RETURN(msg, -1);
@@ -81,50 +348,45 @@ int i2c_master_read(I2C_MSG *msg, uint8_t retry)
 		return -1;
 	}
 
-	int status;
-	status = k_mutex_lock(&i2c_mutex[msg->bus], K_MSEC(1000));
+	bool is_priority = is_i2c_priority_thread();
+	int status = i2c_bus_lock(msg->bus, is_priority);
 	if (status) {
 		LOG_ERR("I2C %d master read get mutex timeout with ret %d", msg->bus, status);
 		return ENOLCK;
 	}
 
 	int ret = -1;
-	uint8_t *txbuf = NULL, *rxbuf = NULL;
-	txbuf = (uint8_t *)malloc(I2C_BUFF_SIZE * sizeof(uint8_t));
-	if (!txbuf) {
-		LOG_ERR("Failed to malloc txbuf");
-		goto exit;
-	}
-	rxbuf = (uint8_t *)malloc(I2C_BUFF_SIZE * sizeof(uint8_t));
-	if (!rxbuf) {
-		LOG_ERR("Failed to malloc rxbuf");
-		goto exit;
-	}
+	uint8_t *txbuf = i2c_txbuf[msg->bus];
 	memcpy(txbuf, &msg->data[0], msg->tx_len);
 
 	uint8_t i;
 	for (i = 0; i <= retry; i++) {
 		if (msg->tx_len > 0) {
-			ret = i2c_write_read(dev_i2c[msg->bus], msg->target_addr, txbuf, msg->tx_len, rxbuf,
-				     msg->rx_len);
-		} else  {
-			ret = i2c_read(dev_i2c[msg->bus], rxbuf, msg->rx_len, msg->target_addr);
+			ret = i2c_write_read(dev_i2c[msg->bus], msg->target_addr, txbuf,
+					     msg->tx_len, &msg->data[0], msg->rx_len);
+		} else {
+			ret = i2c_read(dev_i2c[msg->bus], &msg->data[0], msg->rx_len,
+				       msg->target_addr);
 		}
 		if (ret == 0) { // i2c write read success
-			memcpy(&msg->data[0], rxbuf, msg->rx_len);
 			LOG_HEXDUMP_DBG(msg->data, msg->rx_len, "rxbuf");
 			break;
 		}
 	}
 
-	if (i > retry)
-		LOG_ERR("I2C %d master read retry reach max with ret %d", msg->bus, ret);
+	if (i > 0) {
+		i2c_select_cache_invalidate(msg->bus);
+	} else if (msg->tx_len > 0) {
+		i2c_select_cache_read_notify(msg->bus, msg->target_addr, txbuf, msg->tx_len);
+	}
 
-exit:
-	SAFE_FREE(txbuf);
-	SAFE_FREE(rxbuf);
+	if (i > retry) {
+		LOG_ERR("I2C %d master read retry reach max with ret %d", msg->bus, ret);
+		// Keep the write bytes for callers which retry with the same message
+		memcpy(&msg->data[0], txbuf, msg->tx_len);
+	}
 
-	status = k_mutex_unlock(&i2c_mutex[msg->bus]);
+	status = i2c_bus_unlock(msg->bus, is_priority);
 	if (status)
 		LOG_ERR("I2C %d master read release mutex fail with ret %d", msg->bus, status);
 
@@ -148,42 +410,218 @@ int i2c_master_write(I2C_MSG *msg, uint8_t retry)
 		return -1;
 	}
 
-	int status;
-	status = k_mutex_lock(&i2c_mutex[msg->bus], K_MSEC(1000));
+	bool is_priority = is_i2c_priority_thread();
+	int status = i2c_bus_lock(msg->bus, is_priority);
 	if (status) {
 		LOG_ERR("I2C %d master write get mutex timeout with ret %d", msg->bus, status);
 		return ENOLCK;
 	}
 
 	int ret = -1;
-	uint8_t *txbuf = NULL;
-	txbuf = (uint8_t *)malloc(I2C_BUFF_SIZE * sizeof(uint8_t));
-	if (!txbuf) {
-		LOG_ERR("Failed to malloc txbuf");
-		goto exit;
-	}
-	memcpy(txbuf, &msg->data[0], msg->tx_len);
-
 	uint8_t i;
 	for (i = 0; i <= retry; i++) {
-		ret = i2c_write(dev_i2c[msg->bus], txbuf, msg->tx_len, msg->target_addr);
+		ret = i2c_write(dev_i2c[msg->bus], &msg->data[0], msg->tx_len, msg->target_addr);
 		if (ret == 0) // i2c write success
 			break;
 	}
 
+	if (i > 0) {
+		i2c_select_cache_invalidate(msg->bus);
+	} else {
+		i2c_select_cache_write_notify(msg->bus, msg->target_addr);
+	}
+
 	if (i > retry)
 		LOG_ERR("I2C %d master write retry reach max with ret %d", msg->bus, ret);
 
-exit:
-	SAFE_FREE(txbuf);
-
-	status = k_mutex_unlock(&i2c_mutex[msg->bus]);
+	status = i2c_bus_unlock(msg->bus, is_priority);
 	if (status)
 		LOG_ERR("I2C %d master write release mutex fail with ret %d", msg->bus, status);
 
 	return ret;
 }
 
+/* Write a select command with i2c_mutex held, without dropping the cached state of the bus */
+static int i2c_select_write(uint8_t bus, uint8_t addr, uint8_t *data, uint8_t len, uint8_t retry)
+{
+	int ret = -1;
+	uint8_t i;
+
+	for (i = 0; i <= retry; i++) {
+		ret = i2c_write(dev_i2c[bus], data, len, addr);
+		if (ret == 0)
+			break;
+	}
+
+	if (i > 0) {
+		i2c_select_cache_invalidate(bus);
+	}
+
+	if (i > retry)
+		LOG_ERR("I2C %d select write retry reach max with ret %d", bus, ret);
+
+	return ret;
+}
+
+/* Write mux control byte, skipped if the mux is known to hold it already. Return 0 on success */
+int i2c_master_write_mux(uint8_t bus, uint8_t mux_addr, uint8_t ctrl, uint8_t retry)
+{
+	if ((bus >= I2C_BUS_MAX_NUM) || (check_i2c_bus_valid(bus) < 0)) {
+		LOG_ERR("i2c bus %d is invalid", bus);
+		return -1;
+	}
+
+	bool is_priority = is_i2c_priority_thread();
+	int status = i2c_bus_lock(bus, is_priority);
+	if (status) {
+		LOG_ERR("I2C %d mux write get mutex timeout with ret %d", bus, status);
+		return ENOLCK;
+	}
+
+	int ret = 0;
+	i2c_select_state *state = find_i2c_select_state(bus, mux_addr);
+	if ((state == NULL) || (state->type != I2C_SELECT_MUX) || (state->value != ctrl)) {
+		atomic_val_t gen = atomic_get(&i2c_select_cache_gen[bus]);
+
+		ret = i2c_select_write(bus, mux_addr, &ctrl, 1, retry);
+		// Devices behind the mux are other ones now, so only the mux is known in the next
+		// generation. If the bus was forgotten during the write, the mux isn't known either.
+		if ((ret == 0) && atomic_cas(&i2c_select_cache_gen[bus], gen, gen + 1)) {
+			update_i2c_select_state(bus, mux_addr, I2C_SELECT_MUX, ctrl, gen + 1);
+		} else if (ret == 0) {
+			i2c_select_cache_invalidate(bus);
+		}
+	}
+
+	status = i2c_bus_unlock(bus, is_priority);
+	if (status)
+		LOG_ERR("I2C %d mux write release mutex fail with ret %d", bus, status);
+
+	return ret;
+}
+
+/* Write PMBus PAGE, skipped if the device is known to be on the page. Return 0 on success */
+int i2c_master_write_page(uint8_t bus, uint8_t target_addr, uint8_t page, uint8_t retry)
+{
+	if ((bus >= I2C_BUS_MAX_NUM) || (check_i2c_bus_valid(bus) < 0)) {
+		LOG_ERR("i2c bus %d is invalid", bus);
+		return -1;
+	}
+
+	bool is_priority = is_i2c_priority_thread();
+	int status = i2c_bus_lock(bus, is_priority);
+	if (status) {
+		LOG_ERR("I2C %d page write get mutex timeout with ret %d", bus, status);
+		return ENOLCK;
+	}
+
+	int ret = 0;
+	i2c_select_state *state = find_i2c_select_state(bus, target_addr);
+	if ((state == NULL) || (state->type != I2C_SELECT_PAGE) || (state->value != page)) {
+		uint8_t data[2] = { I2C_PMBUS_PAGE_CMD, page };
+		atomic_val_t gen = atomic_get(&i2c_select_cache_gen[bus]);
+
+		ret = i2c_select_write(bus, target_addr, data, sizeof(data), retry);
+		if (ret == 0) {
+			update_i2c_select_state(bus, target_addr, I2C_SELECT_PAGE, page, gen);
+		}
+	}
+
+	status = i2c_bus_unlock(bus, is_priority);
+	if (status)
+		LOG_ERR("I2C %d page write release mutex fail with ret %d", bus, status);
+
+	return ret;
+}
+
+static void i2c_async_handler(struct k_work *work)
+{
+	i2c_async_bus *async_bus = CONTAINER_OF(work, i2c_async_bus, work);
+
+	while (1) {
+		i2c_async_req *req = NULL;
+		for (uint8_t prio = 0; (prio < I2C_ASYNC_PRIORITY_MAX) && (req == NULL); prio++) {
+			req = k_fifo_get(&async_bus->fifo[prio], K_NO_WAIT);
+		}
+		if (req == NULL) {
+			break;
+		}
+
+		bool is_priority =
+			(req->priority == I2C_ASYNC_PRIORITY_HIGH) && (i2c_priority_enter() == 0);
+		if (req->type == I2C_READ) {
+			req->ret = i2c_master_read(req->msg, req->retry);
+		} else {
+			req->ret = i2c_master_write(req->msg, req->retry);
+		}
+		if (is_priority) {
+			i2c_priority_exit();
+		}
+
+		if (req->signal) {
+			k_poll_signal_raise(req->signal, req->ret);
+		}
+		if (req->complete) {
+			req->complete(req);
+		}
+	}
+}
+
+/*
+ * Queue a transfer on the bus of req->msg and return immediately. The request and its message
+ * must stay valid until the result is reported through req->signal or req->complete.
+ */
+int i2c_master_submit(i2c_async_req *req)
+{
+	CHECK_NULL_ARG_WITH_RETURN(req, -1);
+	CHECK_NULL_ARG_WITH_RETURN(req->msg, -1);
+
+	uint8_t bus = req->msg->bus;
+	if ((bus >= I2C_BUS_MAX_NUM) || (check_i2c_bus_valid(bus) < 0)) {
+		LOG_ERR("i2c bus %d is invalid", bus);
+		return -1;
+	}
+
+	if ((req->type != I2C_READ) && (req->type != I2C_WRITE)) {
+		LOG_ERR("Invalid i2c transfer type %d", req->type);
+		return -1;
+	}
+
+	if (req->priority >= I2C_ASYNC_PRIORITY_MAX) {
+		req->priority = I2C_ASYNC_PRIORITY_LOW;
+	}
+
+	req->ret = -1;
+	k_fifo_put(&i2c_async[bus].fifo[req->priority], req);
+	k_work_submit_to_queue(&i2c_async_work_q[bus % I2C_ASYNC_WORKQ_MAX], &i2c_async[bus].work);
+	return 0;
+}
+
+/* Queue a transfer and wait for its result, without the bus lock timeout of direct transfers */
+int i2c_master_transfer(I2C_MSG *msg, uint8_t type, uint8_t retry, uint8_t priority)
+{
+	CHECK_NULL_ARG_WITH_RETURN(msg, -1);
+
+	struct k_poll_signal signal;
+	struct k_poll_event event =
+		K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &signal);
+	i2c_async_req req = { 0 };
+
+	k_poll_signal_init(&signal);
+	req.msg = msg;
+	req.type = type;
+	req.retry = retry;
+	req.priority = priority;
+	req.signal = &signal;
+
+	if (i2c_master_submit(&req)) {
+		return -1;
+	}
+
+	k_poll(&event, 1, K_FOREVER);
+	return req.ret;
+}
+
 void i2c_scan(uint8_t bus, uint8_t *target_addr, uint8_t *target_addr_len)
 {
 	CHECK_NULL_ARG(target_addr);
@@ -318,6 +756,23 @@ void util_init_I2C(void)
 	if (status)
 		LOG_ERR("i2c15 mutex init fail");
 #endif
+
+	for (int bus = 0; bus < I2C_BUS_MAX_NUM; bus++) {
+		k_condvar_init(&i2c_priority_done[bus]);
+		for (int prio = 0; prio < I2C_ASYNC_PRIORITY_MAX; prio++) {
+			k_fifo_init(&i2c_async[bus].fifo[prio]);
+		}
+		k_work_init(&i2c_async[bus].work, i2c_async_handler);
+	}
+
+	for (int i = 0; i < I2C_ASYNC_WORKQ_MAX; i++) {
+		char name[MAX_I2C_ASYNC_WORKQ_NAME_LEN];
+		snprintf(name, sizeof(name), "i2c_async_%d", i);
+		k_work_queue_start(&i2c_async_work_q[i], i2c_async_work_stack[i],
+				   K_THREAD_STACK_SIZEOF(i2c_async_work_stack[i]),
+				   K_PRIO_PREEMPT(CONFIG_MAIN_THREAD_PRIORITY), NULL);
+		k_thread_name_set(&i2c_async_work_q[i].thread, name);
+	}
 }
 
 int check_i2c_bus_valid(uint8_t bus)
@@ -88,6 +88,16 @@
 
 #define I2C_BUFF_SIZE 256
 
+#define I2C_BUS_LOCK_TIMEOUT_MS 1000
+// Threads which could be marked by i2c_priority_enter() at the same time
+#define I2C_PRIORITY_THREAD_MAX 8
+
+#define I2C_ASYNC_WORKQ_MAX_DEFAULT 1
+#define I2C_ASYNC_STACK_SIZE 1024
+
+// Number of mux/PAGE states remembered per bus
+#define I2C_SELECT_CACHE_SIZE 4
+
 enum I2C_TRANSFER_TYPE {
 	I2C_READ,
 	I2C_WRITE,
@@ -102,9 +112,40 @@ typedef struct _I2C_MSG_ {
 	struct k_mutex lock;
 } I2C_MSG;
 
+// High priority requests are also done as priority transfers, see i2c_priority_enter()
+enum I2C_ASYNC_PRIORITY {
+	I2C_ASYNC_PRIORITY_HIGH, // Management commands, e.g. IPMI/PLDM requested transfers
+	I2C_ASYNC_PRIORITY_LOW, // Background work, e.g. sensor polling
+	I2C_ASYNC_PRIORITY_MAX,
+};
+
+typedef struct _i2c_async_req i2c_async_req;
+
+struct _i2c_async_req {
+	void *fifo_reserved; // First word is reserved for k_fifo
+	I2C_MSG *msg;
+	uint8_t type; // I2C_READ or I2C_WRITE
+	uint8_t retry;
+	uint8_t priority;
+	int ret;
+	// Optional, raised with the transfer result once the request is done
+	struct k_poll_signal *signal;
+	// Optional, called from the bus worker after the signal is raised
+	void (*complete)(i2c_async_req *req);
+	void *user_data;
+};
+
 int i2c_freq_set(uint8_t i2c_bus, uint8_t i2c_speed_mode, uint8_t en_slave);
 int i2c_master_read(I2C_MSG *msg, uint8_t retry);
 int i2c_master_write(I2C_MSG *msg, uint8_t retry);
+int i2c_master_write_mux(uint8_t bus, uint8_t mux_addr, uint8_t ctrl, uint8_t retry);
+int i2c_master_write_page(uint8_t bus, uint8_t target_addr, uint8_t page, uint8_t retry);
+void i2c_select_cache_invalidate(uint8_t bus);
+void i2c_select_cache_invalidate_all(void);
+int i2c_priority_enter(void);
+void i2c_priority_exit(void);
+int i2c_master_submit(i2c_async_req *req);
+int i2c_master_transfer(I2C_MSG *msg, uint8_t type, uint8_t retry, uint8_t priority);
 void i2c_scan(uint8_t bus, uint8_t *target_addr, uint8_t *target_addr_len);
 void util_init_I2C(void);
 int check_i2c_bus_valid(uint8_t bus);
@@ -299,7 +299,7 @@ void util_init_i3c(void)
 #ifdef DEV_I3CSMQ_7
 	dev_i3c_smq[7] = device_get_binding("I3C_SMQ_7");
 #endif
-	for (int i = 0; i <= I3C_MAX_NUM; ++i) {
+	for (int i = 0; i < I3C_MAX_NUM; ++i) {
 		if (k_mutex_init(&mutex_read[i])) {
 			LOG_ERR("Mutex %d init error.",i);
 		}
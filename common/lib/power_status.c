@@ -20,6 +20,7 @@
 #include <logging/log.h>
 
 #include "hal_gpio.h"
+#include "hal_i2c.h"
 #include "snoop.h"
 
 LOG_MODULE_REGISTER(power_status);
@@ -35,6 +36,8 @@ void set_DC_status(uint8_t gpio_num)
 {
 	is_DC_on = (gpio_get(gpio_num) == 1) ? true : false;
 	LOG_WRN("DC_STATUS: %s", (is_DC_on) ? "on" : "off");
+	// Muxes and VRs on DC power come back with their default channel and page
+	i2c_select_cache_invalidate_all();
 }
 
 bool get_DC_status()
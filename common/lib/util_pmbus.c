@@ -15,10 +15,13 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <logging/log.h>
 #include "sensor.h"
 #include "hal_i2c.h"
 #include "pmbus.h"
+#include "util_pmbus.h"
+#include "libutil.h"
 
 LOG_MODULE_REGISTER(util_pmbus);
 
@@ -117,3 +120,161 @@ int pmbus_read_command(uint8_t sensor_num, uint8_t command, uint8_t *result, uin
 	memcpy(result, &msg.data[0], read_len * sizeof(uint8_t));
 	return 0;
 }
+
+__weak bool pal_is_pmbus_batch_post_hook(bool (*post_hook)(uint8_t, void *, int *))
+{
+	/* A batch calls the post sensor read hook once for all its sensors, so only hooks that
+	 * just undo the pre sensor read hook (e.g. release bus mutex or close mux channel) and
+	 * don't touch the reading can be shared.
+	 */
+	ARG_UNUSED(post_hook);
+	return false;
+}
+
+static bool is_pmbus_sensor_type(uint8_t type)
+{
+	switch (type) {
+	case sensor_dev_isl69259:
+	case sensor_dev_adm1278:
+	case sensor_dev_mp5990:
+	case sensor_dev_tps53689:
+	case sensor_dev_xdpe15284:
+	case sensor_dev_ltc4282:
+	case sensor_dev_ina233:
+	case sensor_dev_isl69254iraz_t:
+	case sensor_dev_max16550a:
+	case sensor_dev_xdpe12284c:
+	case sensor_dev_raa229621:
+	case sensor_dev_ltc4286:
+	case sensor_dev_xdpe19283b:
+	case sensor_dev_mp2856gut:
+	case sensor_dev_adm1272:
+	case sensor_dev_q50sn120a1:
+	case sensor_dev_mp2971:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* Whether cfg can be read in the same batch as leader, which means both sensors are on the same
+ * device and the same pre sensor read hook arguments select the same mux channel and PAGE.
+ */
+bool pmbus_is_batch_member(sensor_cfg *leader, sensor_cfg *cfg)
+{
+	CHECK_NULL_ARG_WITH_RETURN(leader, false);
+	CHECK_NULL_ARG_WITH_RETURN(cfg, false);
+
+	if ((leader->type != cfg->type) || !is_pmbus_sensor_type(cfg->type)) {
+		return false;
+	}
+
+	if ((leader->port != cfg->port) || (leader->target_addr != cfg->target_addr)) {
+		return false;
+	}
+
+	if ((leader->pre_sensor_read_hook == NULL) ||
+	    (leader->pre_sensor_read_hook != cfg->pre_sensor_read_hook) ||
+	    (leader->pre_sensor_read_args != cfg->pre_sensor_read_args)) {
+		return false;
+	}
+
+	if ((leader->post_sensor_read_hook != cfg->post_sensor_read_hook) ||
+	    (leader->post_sensor_read_args != cfg->post_sensor_read_args)) {
+		return false;
+	}
+
+	if (cfg->post_sensor_read_hook &&
+	    (pal_is_pmbus_batch_post_hook(cfg->post_sensor_read_hook) == false)) {
+		return false;
+	}
+
+	return true;
+}
+
+/* Read sensors that pmbus_is_batch_member() accepts with one pre sensor read hook call (mux
+ * select and PAGE write), back-to-back register reads and one post sensor read hook call, then
+ * store every reading to its sensor cache. Return the number of sensors read successfully.
+ */
+uint8_t pmbus_batch_read(const uint8_t *sensor_list, uint8_t count)
+{
+	CHECK_NULL_ARG_WITH_RETURN(sensor_list, 0);
+
+	if ((count == 0) || (count > PMBUS_BATCH_MAX)) {
+		LOG_ERR("Invalid PMBus batch size %d", count);
+		return 0;
+	}
+
+	uint8_t batch[PMBUS_BATCH_MAX];
+	uint8_t status[PMBUS_BATCH_MAX];
+	int reading[PMBUS_BATCH_MAX];
+	uint8_t batch_count = 0, read_count = 0, i;
+	int *last_reading = NULL;
+	bool post_ret = true;
+	sensor_cfg *cfg;
+
+	for (i = 0; i < count; i++) {
+		if (!access_check(sensor_list[i])) {
+			cfg = &sensor_config[sensor_config_index_map[sensor_list[i]]];
+			clear_unaccessible_sensor_cache(sensor_list[i]);
+			cfg->cache_status = SENSOR_NOT_ACCESSIBLE;
+			continue;
+		}
+		batch[batch_count++] = sensor_list[i];
+	}
+
+	if (batch_count == 0) {
+		return 0;
+	}
+
+	sensor_cfg *leader = &sensor_config[sensor_config_index_map[batch[0]]];
+	if (leader->pre_sensor_read_hook(leader->num, leader->pre_sensor_read_args) == false) {
+		LOG_ERR("Failed to do pre sensor read function, sensor number: 0x%x", leader->num);
+		for (i = 0; i < batch_count; i++) {
+			sensor_config[sensor_config_index_map[batch[i]]].cache_status =
+				SENSOR_PRE_READ_ERROR;
+		}
+		return 0;
+	}
+	if (leader->cache_status == SENSOR_NOT_PRESENT) {
+		return 0;
+	}
+
+	for (i = 0; i < batch_count; i++) {
+		cfg = &sensor_config[sensor_config_index_map[batch[i]]];
+		status[i] = SENSOR_UNSPECIFIED_ERROR;
+		if (cfg->read) {
+			status[i] = cfg->read(batch[i], &reading[i]);
+		}
+		if ((status[i] == SENSOR_READ_SUCCESS) || (status[i] == SENSOR_READ_ACUR_SUCCESS)) {
+			last_reading = &reading[i];
+		}
+	}
+
+	if (leader->post_sensor_read_hook) {
+		post_ret = leader->post_sensor_read_hook(leader->num, leader->post_sensor_read_args,
+							 last_reading);
+		if (post_ret == false) {
+			LOG_ERR("Failed to do post sensor read function, sensor number: 0x%x",
+				leader->num);
+		}
+	}
+
+	for (i = 0; i < batch_count; i++) {
+		bool is_read_success = (status[i] == SENSOR_READ_SUCCESS) ||
+				       (status[i] == SENSOR_READ_ACUR_SUCCESS);
+		if ((post_ret == false) && is_read_success) {
+			cfg = &sensor_config[sensor_config_index_map[batch[i]]];
+			cfg->retry = 0;
+			cfg->cache_status = SENSOR_POST_READ_ERROR;
+			continue;
+		}
+
+		if (update_sensor_read_result(batch[i], status[i], &reading[i]) ==
+		    SENSOR_READ_4BYTE_ACUR_SUCCESS) {
+			read_count++;
+		}
+	}
+
+	return read_count;
+}
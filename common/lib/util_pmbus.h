@@ -17,8 +17,16 @@
 #ifndef UTIL_PMBUS_H
 #define UTIL_PMBUS_H
 
+#include "sensor.h"
+
+// Max sensors read behind one pre/post sensor read hook pair
+#define PMBUS_BATCH_MAX 8
+
 float slinear11_to_float(uint16_t);
 bool get_exponent_from_vout_mode(uint8_t, float *);
 int pmbus_read_command(uint8_t sensor_num, uint8_t command, uint8_t *result, uint8_t read_len);
+bool pal_is_pmbus_batch_post_hook(bool (*post_hook)(uint8_t, void *, int *));
+bool pmbus_is_batch_member(sensor_cfg *leader, sensor_cfg *cfg);
+uint8_t pmbus_batch_read(const uint8_t *sensor_list, uint8_t count);
 
 #endif
@@ -360,6 +360,33 @@ uint8_t fw_update(uint32_t offset, uint16_t msg_len, uint8_t *msg_buf, uint8_t f
 	return FWUPDATE_SUCCESS;
 }
 
+/* Write an image chunk straight to flash without buffering a whole 64K sector, for callers which
+ * already collect sector sized chunks
+ */
+int fw_update_write(uint32_t offset, uint8_t *buf, uint32_t len, uint8_t flash_position)
+{
+	CHECK_NULL_ARG_WITH_RETURN(buf, -EINVAL);
+
+	if (flash_position >= ARRAY_SIZE(flash_device_list)) {
+		return -EINVAL;
+	}
+
+	const struct device *flash_dev;
+	flash_dev = device_get_binding(flash_device_list[flash_position].name);
+
+	if (!flash_device_list[flash_position].isinit) {
+		int rc = 0;
+		rc = spi_nor_re_init(flash_dev);
+		if (rc != 0) {
+			LOG_ERR("Failed to re-init flash, ret %d.", rc);
+			return rc;
+		}
+		flash_device_list[flash_position].isinit = true;
+	}
+
+	return do_update(flash_dev, offset, buf, len);
+}
+
 int read_fw_image(uint32_t offset, uint8_t msg_len, uint8_t *msg_buf, uint8_t flash_position)
 {
 	CHECK_NULL_ARG_WITH_RETURN(msg_buf, -EINVAL);
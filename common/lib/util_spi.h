@@ -45,6 +45,7 @@ enum DEVICE_POSITIONS {
 
 uint8_t fw_update(uint32_t offset, uint16_t msg_len, uint8_t *msg_buf, uint8_t flag,
 		  uint8_t flash_position);
+int fw_update_write(uint32_t offset, uint8_t *buf, uint32_t len, uint8_t flash_position);
 int read_fw_image(uint32_t offset, uint8_t msg_len, uint8_t *msg_buf, uint8_t flash_position);
 uint8_t fw_update_cxl(uint32_t offset, uint16_t msg_len, uint8_t *msg_buf, bool sector_end);
 
@@ -23,6 +23,7 @@
 #include "hal_gpio.h"
 #include "util_sys.h"
 #include "ipmi.h"
+#include "ipmi_msg_pool.h"
 #include "libutil.h"
 #include "sensor.h"
 
@@ -162,7 +163,7 @@ int set_me_firmware_mode(uint8_t me_fw_mode)
 	}
 
 	int result = 0;
-	ipmi_msg *me_msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+	ipmi_msg *me_msg = (ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 	uint8_t *data = (uint8_t *)malloc(5 * sizeof(uint8_t));
 	if ((me_msg == NULL) || (data == NULL)) {
 		LOG_ERR("Failed to allocate memory");
@@ -243,7 +244,7 @@ int set_me_firmware_mode(uint8_t me_fw_mode)
 
 cleanup:
 	SAFE_FREE(data);
-	SAFE_FREE(me_msg);
+	SAFE_IPMI_MSG_FREE(me_msg);
 	return result;
 }
 
@@ -1,5 +1,6 @@
 #include "cci.h"
 #include "mctp.h"
+#include "mctp_pending.h"
 #include <logging/log.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -16,65 +17,35 @@
 LOG_MODULE_REGISTER(cci);
 
 #define DEFAULT_WAIT_TO_MS 3000
-#define RESP_MSG_PROC_MUTEX_WAIT_TO_MS 1000
-#define TO_CHK_INTERVAL_MS 1000
+/* message tags in use at the same time, the header has room for 256 */
+#define CCI_MSG_TAG_NUM 16
 #define CCI_MSG_MAX_RETRY 3
 #define CCI_MSG_TIMEOUT_MS 3000
 #define CCI_READ_EVENT_SUCCESS BIT(0)
 #define CCI_READ_EVENT_TIMEOUT BIT(1)
 
-static K_MUTEX_DEFINE(wait_recv_resp_mutex);
-
-static sys_slist_t wait_recv_resp_list = SYS_SLIST_STATIC_INIT(&wait_recv_resp_list);
-
-static uint8_t mctp_cci_msg_timeout_check(sys_slist_t *list, struct k_mutex *mutex)
+static void cci_pending_resp(void *msg, uint8_t *buf, uint16_t len)
 {
-	CHECK_NULL_ARG_WITH_RETURN(list, MCTP_ERROR);
-	CHECK_NULL_ARG_WITH_RETURN(mutex, MCTP_ERROR);
-
-	if (k_mutex_lock(mutex, K_MSEC(RESP_MSG_PROC_MUTEX_WAIT_TO_MS))) {
-		LOG_WRN("cci mutex is locked over %d ms!!", RESP_MSG_PROC_MUTEX_WAIT_TO_MS);
-		return MCTP_ERROR;
-	}
-
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	int64_t cur_uptime = k_uptime_get();
-
-	SYS_SLIST_FOR_EACH_NODE_SAFE (list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-
-		if ((p->exp_to_ms <= cur_uptime)) {
-			printk("mctp cci msg timeout!!\n");
-			sys_slist_remove(list, pre_node, node);
-
-			if (p->msg.timeout_cb_fn)
-				p->msg.timeout_cb_fn(p->msg.timeout_cb_fn_args);
-
-			SAFE_FREE(p);
-		} else {
-			pre_node = node;
-		}
-	}
+	mctp_cci_msg *p = (mctp_cci_msg *)msg;
+	mctp_cci_hdr *cci_hdr = (mctp_cci_hdr *)buf;
 
-	k_mutex_unlock(mutex);
-	return MCTP_SUCCESS;
+	if (p->recv_resp_cb_fn)
+		p->recv_resp_cb_fn(p->recv_resp_cb_args, buf + sizeof(p->hdr),
+				   len - sizeof(p->hdr),
+				   cci_hdr->ret); /* remove mctp cci header for handler */
 }
 
-static void mctp_cci_msg_timeout_monitor(void *dummy0, void *dummy1, void *dummy2)
+static void cci_pending_timeout(void *msg)
 {
-	ARG_UNUSED(dummy0);
-	ARG_UNUSED(dummy1);
-	ARG_UNUSED(dummy2);
-
-	while (1) {
-		k_msleep(TO_CHK_INTERVAL_MS);
+	mctp_cci_msg *p = (mctp_cci_msg *)msg;
 
-		mctp_cci_msg_timeout_check(&wait_recv_resp_list, &wait_recv_resp_mutex);
-	}
+	if (p->timeout_cb_fn)
+		p->timeout_cb_fn(p->timeout_cb_fn_args);
 }
 
+MCTP_PENDING_TABLE_DEFINE(cci_pending, CCI_MSG_TAG_NUM, mctp_cci_msg, cci_pending_resp,
+			  cci_pending_timeout);
+
 static void cci_read_timeout_handler(void *args)
 {
 	CHECK_NULL_ARG(args);
@@ -89,40 +60,13 @@ static uint8_t mctp_cci_cmd_resp_process(mctp *mctp_inst, uint8_t *buf, uint32_t
 	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, MCTP_ERROR);
 	CHECK_NULL_ARG_WITH_RETURN(buf, MCTP_ERROR);
 
+	if (len < sizeof(mctp_cci_hdr))
+		return MCTP_ERROR;
+
 	mctp_cci_hdr *cci_hdr = (mctp_cci_hdr *)buf;
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	sys_snode_t *found_node = NULL;
 
-	if (k_mutex_lock(&wait_recv_resp_mutex, K_MSEC(RESP_MSG_PROC_MUTEX_WAIT_TO_MS))) {
-		LOG_WRN("mutex is locked over %d ms!", RESP_MSG_PROC_MUTEX_WAIT_TO_MS);
-		return MCTP_ERROR;
-	}
-	SYS_SLIST_FOR_EACH_NODE_SAFE (&wait_recv_resp_list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-		/* found the proper handler */
-		if ((p->mctp_inst == mctp_inst) && (p->msg.hdr.msg_tag == cci_hdr->msg_tag) &&
-		    (p->msg.hdr.op == cci_hdr->op)) {
-			found_node = node;
-			sys_slist_remove(&wait_recv_resp_list, pre_node, node);
-			break;
-		} else {
-			pre_node = node;
-		}
-	}
-	k_mutex_unlock(&wait_recv_resp_mutex);
-
-	if (found_node) {
-		/* invoke resp handler */
-		wait_msg *p = (wait_msg *)found_node;
-		if (p->msg.recv_resp_cb_fn)
-			p->msg.recv_resp_cb_fn(
-				p->msg.recv_resp_cb_args, buf + sizeof(p->msg.hdr),
-				len - sizeof(p->msg.hdr),
-				cci_hdr->ret); /* remove mctp cci header for handler */
-		SAFE_FREE(p);
-	}
+	mctp_pending_resp(&cci_pending, cci_hdr->msg_tag, mctp_inst, ext_params.ep, cci_hdr->op,
+			  buf, len);
 
 	return MCTP_SUCCESS;
 }
@@ -134,10 +78,19 @@ uint8_t mctp_cci_send_msg(void *mctp_p, mctp_cci_msg *msg)
 
 	mctp *mctp_inst = (mctp *)mctp_p;
 
+	int msg_tag = -1;
 	if (!msg->hdr.cci_msg_req_resp) {
-		msg->hdr.msg_tag = mctp_inst->cci_msg_tag++;
+		msg_tag = mctp_pending_alloc(&cci_pending);
+		if (msg_tag < 0)
+			return CCI_ERROR;
+
+		msg->hdr.msg_tag = msg_tag;
 		msg->hdr.msg_type = MCTP_MSG_TYPE_CCI;
 		msg->ext_params.tag_owner = 1;
+
+		mctp_pending_start(&cci_pending, msg_tag, mctp_inst, msg->ext_params.ep,
+				   msg->hdr.op, msg,
+				   msg->timeout_ms ? msg->timeout_ms : DEFAULT_WAIT_TO_MS);
 	}
 
 	uint16_t len = sizeof(msg->hdr) + msg->hdr.pl_len;
@@ -149,29 +102,15 @@ uint8_t mctp_cci_send_msg(void *mctp_p, mctp_cci_msg *msg)
 	}
 	LOG_HEXDUMP_DBG(buf, len, __func__);
 
-	uint8_t rc = mctp_send_msg(mctp_inst, buf, len, msg->ext_params);
+	uint8_t rc = (msg_tag >= 0) ? mctp_send_msg_sync(mctp_inst, buf, len, msg->ext_params) :
+				    mctp_send_msg(mctp_inst, buf, len, msg->ext_params);
 
 	if (rc == CCI_ERROR) {
 		LOG_WRN("mctp_send_msg error!!");
+		if (msg_tag >= 0)
+			mctp_pending_cancel(&cci_pending, msg_tag, msg);
 		return CCI_ERROR;
 	}
-	if (!msg->hdr.cci_msg_req_resp) {
-		wait_msg *p = (wait_msg *)malloc(sizeof(*p));
-		if (!p) {
-			LOG_WRN("wait_msg alloc failed!");
-			return CCI_ERROR;
-		}
-
-		memset(p, 0, sizeof(*p));
-		p->mctp_inst = mctp_inst;
-		p->msg = *msg;
-		p->exp_to_ms =
-			k_uptime_get() + (msg->timeout_ms ? msg->timeout_ms : DEFAULT_WAIT_TO_MS);
-
-		k_mutex_lock(&wait_recv_resp_mutex, K_FOREVER);
-		sys_slist_append(&wait_recv_resp_list, &p->node);
-		k_mutex_unlock(&wait_recv_resp_mutex);
-	}
 
 	return CCI_SUCCESS;
 }
@@ -240,6 +179,8 @@ uint16_t mctp_cci_read(void *mctp_p, mctp_cci_msg *msg, uint8_t *rbuf, uint16_t
 		}
 		if (k_msgq_get(event_msgq_p, &event, K_MSEC(CCI_MSG_TIMEOUT_MS + 1000))) {
 			LOG_WRN("Failed to get status from msgq!");
+			mctp_pending_cancel(&cci_pending, msg->hdr.msg_tag, msg);
+			k_msgq_purge(event_msgq_p);
 			continue;
 		}
 		if (event == CCI_READ_EVENT_SUCCESS) {
@@ -358,6 +299,4 @@ bool cci_get_chip_fw_version(void *mctp_p, mctp_ext_params ext_params, uint8_t *
 	return true;
 }
 
-K_THREAD_DEFINE(monitor_cci_msg, 1024, mctp_cci_msg_timeout_monitor, NULL, NULL, NULL, 7, 0, 0);
-
 #endif
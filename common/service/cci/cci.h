@@ -96,13 +96,6 @@ typedef struct _mctp_cci_cmd_handler {
 #define CCI_ERROR 0x0001
 #define CCI_INVALID_TYPE 0x0002
 
-typedef struct _wait_msg {
-	sys_snode_t node;
-	mctp *mctp_inst;
-	int64_t exp_to_ms;
-	mctp_cci_msg msg;
-} wait_msg;
-
 /*CCI command handler */
 uint8_t mctp_cci_cmd_handler(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext_params ext_params);
 void cci_read_resp_handler(void *args, uint8_t *rbuf, uint16_t rlen, uint16_t ret_code);
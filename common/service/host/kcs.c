@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <logging/log.h>
 #include "ipmi.h"
+#include "ipmi_msg_pool.h"
 #include "kcs.h"
 #include "pldm.h"
 #include "plat_def.h"
@@ -63,6 +64,7 @@ static void kcs_read_task(void *arvg0, void *arvg1, void *arvg2)
 	ipmb_error status;
 
 	struct kcs_request *req;
+	uint32_t poll_interval = KCS_POLLING_INTERVAL;
 
 	ARG_UNUSED(arvg1);
 	ARG_UNUSED(arvg2);
@@ -73,14 +75,18 @@ static void kcs_read_task(void *arvg0, void *arvg1, void *arvg2)
 	}
 
 	while (1) {
-		k_msleep(KCS_POLLING_INTERVAL);
+		k_msleep(poll_interval);
 
 		rc = kcs_aspeed_read(kcs_inst->dev, ibuf, sizeof(ibuf));
 		if (rc < 0) {
 			if (rc != -ENODATA)
 				LOG_ERR("Failed to read KCS data, rc = %d", rc);
+			// host sends the next request right after reading the response, so start
+			// polling fast after a message and back off while the channel stays idle
+			poll_interval = MIN(poll_interval * 2, KCS_POLLING_INTERVAL);
 			continue;
 		}
+		poll_interval = KCS_BUSY_POLLING_INTERVAL;
 
 		LOG_HEXDUMP_DBG(&ibuf[0], rc, "host KCS read dump data:");
 
@@ -103,17 +109,13 @@ static void kcs_read_task(void *arvg0, void *arvg1, void *arvg2)
 				current_msg.buffer.netfn, current_msg.buffer.cmd,
 				current_msg.buffer.data_len);
 
-			while (k_msgq_put(&ipmi_msgq, &current_msg, K_NO_WAIT) != 0) {
-				k_msgq_purge(&ipmi_msgq);
-				LOG_WRN("KCS retrying put ipmi msgq");
-			}
+			ipmi_msgq_put(&current_msg, K_NO_WAIT);
 		} else { // default command for BMC, should add BIC firmware update, BMC reset, real time sensor read in future
 			if (pal_immediate_respond_from_KCS(req->netfn, req->cmd)) {
-				do { // break if malloc fail.
-					uint8_t *kcs_buff;
-					kcs_buff = malloc(KCS_BUFF_SIZE * sizeof(uint8_t));
+				do { // break if allocate fail.
+					uint8_t *kcs_buff = ipmi_msg_pool_alloc(K_NO_WAIT);
 					if (kcs_buff == NULL) {
-						LOG_ERR("Failed to malloc for kcs_buff");
+						LOG_ERR("Failed to allocate kcs_buff");
 						break;
 					}
 					kcs_buff[0] = (req->netfn | BIT(0)) << 2;
@@ -128,7 +130,7 @@ static void kcs_read_task(void *arvg0, void *arvg1, void *arvg2)
 					} else {
 						kcs_write(kcs_inst->index, kcs_buff, 3);
 					}
-					SAFE_FREE(kcs_buff);
+					SAFE_IPMI_MSG_FREE(kcs_buff);
 				} while (0);
 			}
 			if ((req->netfn == NETFN_APP_REQ) &&
@@ -161,8 +163,7 @@ static void kcs_read_task(void *arvg0, void *arvg1, void *arvg2)
 					LOG_ERR("kcs_read_task send to BMC fail");
 				}
 
-				uint8_t *kcs_buff;
-				kcs_buff = malloc(3 + bridge_msg.data_len);
+				uint8_t *kcs_buff = ipmi_msg_pool_alloc(K_NO_WAIT);
 				if (kcs_buff == NULL) {
 					LOG_ERR("Memory allocation failed");
 					continue;
@@ -178,7 +179,7 @@ static void kcs_read_task(void *arvg0, void *arvg1, void *arvg2)
 					kcs_write(kcs_inst->index, kcs_buff, 3 + bridge_msg.data_len);
 				}
 
-				SAFE_FREE(kcs_buff);
+				SAFE_IPMI_MSG_FREE(kcs_buff);
 			} else {
 				status = ipmb_send_request(&bridge_msg,
 							   IPMB_inf_index_map[BMC_IPMB]);
@@ -25,6 +25,10 @@
 
 #define KCS_POLL_STACK_SIZE 2816
 #define KCS_POLLING_INTERVAL 100
+/* After a message the channel is polled again in KCS_BUSY_POLLING_INTERVAL ms, the interval
+ * doubles on each empty poll up to KCS_POLLING_INTERVAL
+ */
+#define KCS_BUSY_POLLING_INTERVAL 1
 #define KCS_BUFF_SIZE 256
 #define KCS_MAX_CHANNEL_NUM 0x0F
 
@@ -17,6 +17,7 @@
 #include "cmsis_os2.h"
 #include "hal_i2c.h"
 #include "ipmi.h"
+#include "ipmi_msg_pool.h"
 
 #ifdef CONFIG_IPMI_KCS_ASPEED
 #include "kcs.h"
@@ -39,23 +40,23 @@
 
 LOG_MODULE_REGISTER(ipmb);
 
+BUILD_ASSERT(IPMI_MSG_POOL_BUF_SIZE >= (IPMI_MSG_MAX_LENGTH + IPMB_RESP_HEADER_LENGTH),
+	     "IPMB rx buffer does not fit in IPMI message pool buffer");
+BUILD_ASSERT(IPMI_MSG_POOL_BUF_SIZE >= sizeof(I2C_MSG),
+	     "I2C_MSG does not fit in IPMI message pool buffer");
+
 /*
  * If MAX_IPMB_IDX which define by plat_ipmb.h is not equal to zero
  * then compile ipmb.c to avoid creating redundant memory space.
  */
 #if MAX_IPMB_IDX
 
-static struct k_mutex mutex_id[MAX_IPMB_IDX]; // mutex for sequence linked list insert/find
-static struct k_mutex mutex_send_req, mutex_send_res, mutex_read;
+static struct k_mutex mutex_id[MAX_IPMB_IDX]; // mutex for pending request table insert/find
+static struct k_mutex mutex_send_req, mutex_send_res;
 static const struct device *dev_ipmb[I2C_BUS_MAX_NUM];
 
 char __aligned(4) ipmb_txqueue_buffer[MAX_IPMB_IDX][IPMB_TXQUEUE_LEN * sizeof(struct ipmi_msg_cfg)];
-char __aligned(4) ipmb_rxqueue_buffer[MAX_IPMB_IDX][IPMB_RXQUEUE_LEN * sizeof(struct ipmi_msg)];
 struct k_msgq ipmb_txqueue[MAX_IPMB_IDX];
-struct k_msgq ipmb_rxqueue[MAX_IPMB_IDX];
-
-struct k_thread IPMB_SeqTimeout;
-K_KERNEL_STACK_MEMBER(IPMB_SeqTimeout_stack, IPMB_SEQ_TIMEOUT_STACK_SIZE);
 
 K_THREAD_STACK_EXTERN(ipmb_rx_stack);
 K_THREAD_STACK_EXTERN(ipmb_tx_stack);
@@ -68,15 +69,36 @@ static k_tid_t IPMB_TX_ID[MAX_IPMB_IDX];
 static bool ipmb_tx_disable[MAX_IPMB_IDX];
 
 IPMB_config *IPMB_config_table;
-ipmi_msg_cfg *P_start[MAX_IPMB_IDX],
-	*P_temp; // pointer for sequence queue(link list)
-static unsigned int seq_current_count[MAX_IPMB_IDX] = { 0 };
-static uint32_t tick_fix;
-static uint32_t sys_tick_freq;
+
+/* Caller of ipmb_read() waiting for the response of its own request */
+typedef struct _ipmb_waiter {
+	struct k_sem sem;
+	ipmi_msg *msg; // response is copied here
+	ipmb_error ret;
+} ipmb_waiter;
+
+/* Outstanding IPMB request, indexed by the sequence number sent to the target */
+typedef struct _ipmb_pending_req {
+	bool is_valid;
+	ipmb_waiter *waiter; // NULL if nobody waits for the response
+	uint8_t netfn;
+	uint8_t cmd;
+	uint8_t seq_source;
+	uint8_t InF_source;
+	uint8_t InF_target;
+	uint8_t pldm_inst_id;
+	int64_t deadline; // ms, uptime when the request expires
+} ipmb_pending_req;
+
+static ipmb_pending_req pending_req[MAX_IPMB_IDX][SEQ_NUM];
 
 static uint8_t current_seq[MAX_IPMB_IDX]; // Sequence in BIC for sending
 	// sequence to other IPMB devices
-static bool seq_table[MAX_IPMB_IDX][SEQ_NUM]; // Sequence table in BIC for register record
+
+static void ipmb_seq_timeout_handler(struct k_work *work);
+K_WORK_DELAYABLE_DEFINE(ipmb_seq_timeout_work, ipmb_seq_timeout_handler);
+static K_MUTEX_DEFINE(mutex_seq_timeout);
+static int64_t seq_timeout_deadline; // ms, uptime the timeout work is armed for, 0 if not armed
 
 ipmb_error validate_checksum(uint8_t *buffer, uint8_t buffer_len);
 ipmb_error ipmb_encode(uint8_t *buffer, ipmi_msg *msg);
@@ -117,14 +139,34 @@ uint8_t calculate_checksum(uint8_t *buffer, uint8_t range)
 	return checksum;
 }
 
+/* Checksum of a frame as received from the IPMB slave driver, which keeps the 8bit address in
+ * byte 0 */
+static uint8_t calculate_frame_checksum(const uint8_t *frame, uint8_t range)
+{
+	uint8_t checksum = 0;
+	uint8_t i;
+
+	checksum -= frame[0] & 0xFE;
+	for (i = 1; i < range; i++) {
+		checksum -= frame[i];
+	}
+
+	return checksum;
+}
+
 ipmb_error validate_checksum(uint8_t *buffer, uint8_t buffer_len)
 {
 	CHECK_NULL_ARG_WITH_RETURN(buffer, IPMB_ERROR_UNKNOWN);
 
+	if (buffer_len <= IPMB_REQ_HEADER_LENGTH) {
+		return IPMB_ERROR_INVALID_REQ;
+	}
+
 	uint8_t header_checksum = buffer[2];
 	uint8_t msg_checksum = buffer[buffer_len - 1];
-	uint8_t calc_header_checksum = calculate_checksum(buffer, IPMI_HEADER_CHECKSUM_POSITION);
-	uint8_t calc_msg_checksum = calculate_checksum(buffer, buffer_len - 1);
+	uint8_t calc_header_checksum =
+		calculate_frame_checksum(buffer, IPMI_HEADER_CHECKSUM_POSITION);
+	uint8_t calc_msg_checksum = calculate_frame_checksum(buffer, buffer_len - 1);
 
 	if (header_checksum == calc_header_checksum) {
 		if (msg_checksum == calc_msg_checksum) {
@@ -136,23 +178,13 @@ ipmb_error validate_checksum(uint8_t *buffer, uint8_t buffer_len)
 	return IPMB_ERROR_MSG_CHECKSUM;
 }
 
-void unregister_seq(uint8_t index, uint8_t seq_num)
-{
-	seq_table[index][seq_num] = 0;
-}
-
-void register_seq(uint8_t index, uint8_t seq_num)
-{
-	seq_table[index][seq_num] = 1;
-}
-
 uint8_t get_free_seq(uint8_t index)
 {
 	uint8_t count = 0;
 
 	do {
 		current_seq[index] = (current_seq[index] + 1) & 0x3f;
-		if (!seq_table[index][current_seq[index]]) {
+		if (!pending_req[index][current_seq[index]].is_valid) {
 			break;
 		}
 
@@ -166,160 +198,113 @@ uint8_t get_free_seq(uint8_t index)
 	return current_seq[index];
 }
 
+/* Release a pending request and wake up its waiter with ret, caller must hold mutex_id */
+static void complete_req(ipmb_pending_req *req, ipmb_error ret)
+{
+	if (req->waiter) {
+		req->waiter->ret = ret;
+		k_sem_give(&req->waiter->sem);
+		req->waiter = NULL;
+	}
+	req->is_valid = false;
+}
+
+/* Arm the timeout work for deadline unless it is already armed for an earlier one */
+static void arm_seq_timeout(int64_t deadline)
+{
+	k_mutex_lock(&mutex_seq_timeout, K_FOREVER);
+	if ((seq_timeout_deadline == 0) || (deadline < seq_timeout_deadline)) {
+		int64_t delay_ms = deadline - k_uptime_get();
+		k_work_reschedule(&ipmb_seq_timeout_work, K_MSEC(MAX(delay_ms, 0)));
+		seq_timeout_deadline = deadline;
+	}
+	k_mutex_unlock(&mutex_seq_timeout);
+}
+
 /* Record IPMB request for checking response sequence and finding source
  * sequence for bridge command */
-void insert_req_ipmi_msg(ipmi_msg_cfg *pnode, ipmi_msg *msg, uint8_t index)
+static ipmb_error insert_req_ipmi_msg(ipmi_msg *msg, uint8_t index, ipmb_waiter *waiter,
+				      uint32_t timeout_ms)
 {
-	CHECK_NULL_ARG(pnode);
-	CHECK_NULL_ARG(msg);
-
-	ipmi_msg_cfg *ptr_start = pnode;
-	int ret;
+	CHECK_NULL_ARG_WITH_RETURN(msg, IPMB_ERROR_UNKNOWN);
 
-	ret = k_mutex_lock(&mutex_id[index], K_MSEC(1000));
+	int ret = k_mutex_lock(&mutex_id[index], K_MSEC(1000));
 	if (ret) {
 		LOG_ERR("Failed to lock the mutex(%d)", ret);
-		return;
-	} else {
-		// No more room, remove the first node.
-		if (seq_current_count[index] == MAX_SEQ_QUENE) {
-			ipmi_msg_cfg *temp;
-			temp = pnode->next;
-			if (temp == NULL) {
-				LOG_ERR("Not a circular linked list");
-				k_mutex_unlock(&mutex_id[index]);
-				return;
-			}
-
-			pnode->next = temp->next;
-			SAFE_FREE(temp);
-			seq_current_count[index]--;
-		}
-
-		while (pnode && pnode->next != ptr_start) {
-			pnode = pnode->next;
-		}
-
-		if (pnode == NULL) {
-			LOG_ERR("Not a circular linked list");
-			k_mutex_unlock(&mutex_id[index]);
-			return;
-		}
+		return IPMB_ERROR_MUTEX_LOCK;
+	}
 
-		/* Allocate memory for the new node and put data in it.*/
-		pnode->next = malloc(sizeof(ipmi_msg_cfg));
-		if (pnode->next == NULL) {
-			k_mutex_unlock(&mutex_id[index]);
-			return;
-		}
-		pnode = pnode->next;
+	ipmb_pending_req *req = &pending_req[index][msg->seq_target & 0x3f];
+	if (req->is_valid) {
+		LOG_WRN("IPMB[%x] seq %d reused before response, netfn 0x%x cmd 0x%x", index,
+			msg->seq_target, req->netfn, req->cmd);
+		complete_req(req, IPMB_ERROR_FAILURE);
+	}
 
-		msg->timestamp = osKernelGetSysTimerCount();
-		memcpy(&pnode->buffer, msg, sizeof(ipmi_msg));
-		register_seq(index, pnode->buffer.seq_target);
+	req->netfn = msg->netfn;
+	req->cmd = msg->cmd;
+	req->seq_source = msg->seq_source;
+	req->InF_source = msg->InF_source;
+	req->InF_target = msg->InF_target;
+	req->pldm_inst_id = msg->pldm_inst_id;
+	int64_t deadline = k_uptime_get() + timeout_ms;
+	req->deadline = deadline;
+	req->waiter = waiter;
+	req->is_valid = true;
+	k_mutex_unlock(&mutex_id[index]);
 
-		pnode->next = ptr_start;
-		seq_current_count[index]++;
-		k_mutex_unlock(&mutex_id[index]);
-		return;
-	}
+	arm_seq_timeout(deadline);
+	return IPMB_ERROR_SUCCESS;
 }
 
 /* Find if any IPMB request record match receiving response */
-bool find_req_ipmi_msg(ipmi_msg_cfg *pnode, ipmi_msg *msg, uint8_t index)
+bool find_req_ipmi_msg(ipmi_msg *msg, uint8_t index)
 {
-	CHECK_NULL_ARG_WITH_RETURN(pnode, false);
 	CHECK_NULL_ARG_WITH_RETURN(msg, false);
 
-	ipmi_msg_cfg *ptr_start = pnode;
-	int ret;
-
-	ret = k_mutex_lock(&mutex_id[index], K_MSEC(1000));
+	int ret = k_mutex_lock(&mutex_id[index], K_MSEC(1000));
 	if (ret) {
 		LOG_ERR("Failed to lock the mutex(%d)", ret);
 		return false;
 	}
 
-	while ((pnode != NULL && pnode->next != ptr_start) &&
-	       (((pnode->next)->buffer.netfn != (msg->netfn - 1)) ||
-		((pnode->next)->buffer.cmd != msg->cmd) ||
-		((pnode->next)->buffer.seq_target != msg->seq_target))) {
-		pnode = pnode->next;
-	}
-
-	if (pnode == NULL) {
-		LOG_ERR("pnode list should be circular, list end found");
-		k_mutex_unlock(&mutex_id[index]);
-		return false;
-	}
-
-	if (pnode->next == ptr_start) {
+	ipmb_pending_req *req = &pending_req[index][msg->seq_target & 0x3f];
+	if (!req->is_valid || (req->netfn != (msg->netfn - 1)) || (req->cmd != msg->cmd)) {
 		LOG_ERR("no req match recv resp");
-		LOG_ERR("node netfn: %x,cmd: %x, seq_t: %x", (pnode->next)->buffer.netfn,
-			(pnode->next)->buffer.cmd, (pnode->next)->buffer.seq_target);
+		LOG_ERR("node valid: %d netfn: %x,cmd: %x", req->is_valid, req->netfn, req->cmd);
 		LOG_ERR("msg netfn: %x,cmd: %x, seq_t: %x", msg->netfn, msg->cmd, msg->seq_target);
 		k_mutex_unlock(&mutex_id[index]);
 		return false;
 	}
 
-	/* Now pointer points to a node and the node next to it has to be removed */
-	ipmi_msg_cfg *temp;
-	temp = pnode->next;
-
-	if (temp == NULL) {
-		LOG_ERR("pnode list should be circular, list end found");
-		k_mutex_unlock(&mutex_id[index]);
-		return false;
-	}
-
 	// find source sequence for responding
-	msg->seq_source = temp->buffer.seq_source;
-	unregister_seq(index, temp->buffer.seq_target);
-
-	msg->pldm_inst_id = temp->buffer.pldm_inst_id;
-	msg->InF_source = temp->buffer.InF_source;
-	msg->InF_target = temp->buffer.InF_target;
-	/*temp points to the node which has to be removed*/
-	pnode->next = temp->next;
-	/*We removed the node which is next to the pointer (which is also temp) */
-
-	/* Because we deleted the node, we no longer require the memory used for it
-   * free() will deallocate the memory.
-   */
-	SAFE_FREE(temp);
-	seq_current_count[index]--;
+	msg->seq_source = req->seq_source;
+	msg->pldm_inst_id = req->pldm_inst_id;
+	msg->InF_source = req->InF_source;
+	msg->InF_target = req->InF_target;
+	if (req->waiter) {
+		memcpy(req->waiter->msg, msg, sizeof(ipmi_msg));
+	}
+	complete_req(req, IPMB_ERROR_SUCCESS);
 
 	k_mutex_unlock(&mutex_id[index]);
 	return true;
 }
 
-void clear_req_ipmi_msg(ipmi_msg_cfg *pnode, ipmi_msg *msg, uint8_t index)
+/* Drop the record of a request which is not going to get a response */
+void clear_req_ipmi_msg(ipmi_msg *msg, uint8_t index)
 {
-	CHECK_NULL_ARG(pnode);
 	CHECK_NULL_ARG(msg);
 
-	int ret = 0;
-
-	// Mutex for request sequence linked list change
-	ret = k_mutex_lock(&mutex_id[index], K_MSEC(1000));
+	int ret = k_mutex_lock(&mutex_id[index], K_MSEC(1000));
 	if (ret) {
 		LOG_ERR("Failed to lock the mutex id%d, ret%d", index, ret);
 		return;
 	}
 
-	ipmi_msg_cfg *temp = NULL;
-	while (pnode->next != P_start[index]) {
-		temp = pnode->next;
-		if ((temp->buffer.netfn == msg->netfn) && (temp->buffer.cmd == msg->cmd) &&
-		    (temp->buffer.seq == msg->seq)) {
-			pnode->next = temp->next;
-			unregister_seq(index, temp->buffer.seq_target);
-			SAFE_FREE(temp);
-			seq_current_count[index]--;
-			break;
-		}
-
-		pnode = pnode->next;
+	ipmb_pending_req *req = &pending_req[index][msg->seq & 0x3f];
+	if (req->is_valid && (req->netfn == msg->netfn) && (req->cmd == msg->cmd)) {
+		complete_req(req, IPMB_ERROR_FAILURE);
 	}
 
 	k_mutex_unlock(&mutex_id[index]);
@@ -368,22 +353,35 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 	I2C_MSG *i2c_msg;
 	uint8_t ipmb_buffer_tx[IPMI_MSG_MAX_LENGTH + IPMB_RESP_HEADER_LENGTH];
 	uint8_t ret = 0;
+	struct k_poll_event tx_event;
 
 	memcpy(&ipmb_cfg, (IPMB_config *)pvParameters, sizeof(IPMB_config));
+	k_poll_event_init(&tx_event, K_POLL_TYPE_MSGQ_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+			  &ipmb_txqueue[ipmb_cfg.index]);
 
 	while (1) {
-		current_msg_tx = (struct ipmi_msg_cfg *)malloc(sizeof(struct ipmi_msg_cfg));
+		// Wait for a message before taking a pool buffer, so an idle task holds none
+		tx_event.state = K_POLL_STATE_NOT_READY;
+		k_poll(&tx_event, 1, K_FOREVER);
+
+		current_msg_tx = (struct ipmi_msg_cfg *)ipmi_msg_pool_alloc(K_FOREVER);
 		if (current_msg_tx == NULL) {
-			k_msleep(10);
 			continue;
 		}
 
-		k_msgq_get(&ipmb_txqueue[ipmb_cfg.index], (ipmi_msg_cfg *)current_msg_tx,
-			   K_FOREVER); // Wait for OS queue send interrupt
+		if (k_msgq_get(&ipmb_txqueue[ipmb_cfg.index], (ipmi_msg_cfg *)current_msg_tx,
+			       K_NO_WAIT) != 0) {
+			SAFE_IPMI_MSG_FREE(current_msg_tx);
+			continue;
+		}
 
 		// drop the messsage when the disable is set
-		if (ipmb_tx_disable[ipmb_cfg.index])
+		if (ipmb_tx_disable[ipmb_cfg.index]) {
+			if (!IS_RESPONSE(current_msg_tx->buffer)) {
+				clear_req_ipmi_msg(&current_msg_tx->buffer, ipmb_cfg.index);
+			}
 			goto cleanup;
+		}
 
 		if (IS_RESPONSE(current_msg_tx->buffer)) { // Send a response message
 			if (current_msg_tx->retries > IPMB_TX_RETRY_TIME) {
@@ -399,18 +397,10 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 			uint8_t resp_tx_size =
 				current_msg_tx->buffer.data_len + IPMB_RESP_HEADER_LENGTH;
 			if (ipmb_cfg.interface == I2C_IF) {
-				int retry = 0;
-				do {
-					i2c_msg = malloc(sizeof(I2C_MSG));
-					if (i2c_msg == NULL) {
-						k_msleep(10);
-					} else {
-						break;
-					}
-					retry++;
-				} while (retry < MEM_ALLOCATE_RETRY_TIME);
+				i2c_msg = (I2C_MSG *)ipmi_msg_pool_alloc(
+					K_MSEC(10 * MEM_ALLOCATE_RETRY_TIME));
 				if (i2c_msg == NULL) {
-					LOG_ERR("Failed to allocate memory for I2C resp msg");
+					LOG_ERR("Failed to allocate memory for I2C msg");
 					goto cleanup;
 				}
 
@@ -420,7 +410,7 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 				memcpy(&i2c_msg->data[0], &ipmb_buffer_tx[1], resp_tx_size);
 
 				ret = i2c_master_write(i2c_msg, I2C_RETRY_TIME);
-				SAFE_FREE(i2c_msg);
+				SAFE_IPMI_MSG_FREE(i2c_msg);
 			} else {
 				LOG_ERR("Unsupported interface(%d) for index(%d)",
 					ipmb_cfg.interface, ipmb_cfg.index);
@@ -459,18 +449,10 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 				current_msg_tx->buffer.data_len + IPMB_REQ_HEADER_LENGTH;
 
 			if (ipmb_cfg.interface == I2C_IF) {
-				int retry = 0;
-				do {
-					i2c_msg = malloc(sizeof(I2C_MSG));
-					if (i2c_msg == NULL) {
-						k_msleep(10);
-					} else {
-						break;
-					}
-					retry++;
-				} while (retry < MEM_ALLOCATE_RETRY_TIME);
+				i2c_msg = (I2C_MSG *)ipmi_msg_pool_alloc(
+					K_MSEC(10 * MEM_ALLOCATE_RETRY_TIME));
 				if (i2c_msg == NULL) {
-					LOG_ERR("Failed to allocate memory for I2C resp msg");
+					LOG_ERR("Failed to allocate memory for I2C req msg");
 					goto cleanup;
 				}
 
@@ -479,9 +461,6 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 				i2c_msg->tx_len = req_tx_size;
 				memcpy(&i2c_msg->data[0], &ipmb_buffer_tx[1], req_tx_size);
 
-				current_msg_tx->buffer.seq_target = current_msg_tx->buffer.seq;
-				insert_req_ipmi_msg(P_start[ipmb_cfg.index],
-						    &current_msg_tx->buffer, ipmb_cfg.index);
 				if (DEBUG_IPMB) {
 					LOG_DBG("Send a request message, from(%d) to(%d) netfn(0x%x) cmd(0x%x) CC(0x%x)",
 						current_msg_tx->buffer.InF_source,
@@ -499,7 +478,7 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 				}
 
 				ret = i2c_master_write(i2c_msg, I2C_RETRY_TIME);
-				SAFE_FREE(i2c_msg);
+				SAFE_IPMI_MSG_FREE(i2c_msg);
 			} else {
 				LOG_ERR("Unsupported interface(%d) for index(%d)",
 					ipmb_cfg.interface, ipmb_cfg.index);
@@ -507,12 +486,11 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 			}
 
 			if (ret) {
-				find_req_ipmi_msg(P_start[ipmb_cfg.index],
-						  &(current_msg_tx->buffer), ipmb_cfg.index);
-
 				current_msg_tx->retries += 1;
 
 				if (current_msg_tx->retries > IPMB_TX_RETRY_TIME) {
+					clear_req_ipmi_msg(&(current_msg_tx->buffer),
+							   ipmb_cfg.index);
 					if (current_msg_tx->buffer.InF_source == RESERVED) {
 						LOG_ERR("The request message is from RESERVED");
 					} else if (current_msg_tx->buffer.InF_source == SELF) {
@@ -521,18 +499,11 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 						   HOST_KCS_1) {
 						// the source is KCS if the bit[7:4] are 0101b.
 #ifdef CONFIG_IPMI_KCS_ASPEED
-						uint8_t *kcs_buff;
-						kcs_buff = malloc(KCS_BUFF_SIZE * sizeof(uint8_t));
-						if (kcs_buff ==
-						    NULL) { // allocate fail, retry allocate
-							k_msleep(10);
-							kcs_buff = malloc(KCS_BUFF_SIZE *
-									  sizeof(uint8_t));
-							if (kcs_buff == NULL) {
-								LOG_ERR("IPMB_TXTask: Fail to malloc for kcs_buff");
-								SAFE_FREE(current_msg_tx);
-								continue;
-							}
+						uint8_t *kcs_buff = ipmi_msg_pool_alloc(K_MSEC(10));
+						if (kcs_buff == NULL) {
+							LOG_ERR("IPMB_TXTask: Fail to allocate kcs_buff");
+							SAFE_IPMI_MSG_FREE(current_msg_tx);
+							continue;
 						}
 						current_msg_tx->buffer.completion_code =
 							CC_CAN_NOT_RESPOND;
@@ -551,7 +522,7 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 								  HOST_KCS_1,
 							  kcs_buff,
 							  current_msg_tx->buffer.data_len + 3);
-						SAFE_FREE(kcs_buff);
+						SAFE_IPMI_MSG_FREE(kcs_buff);
 #endif
 					} else {
 						// Return the error code(node busy) to the source channel
@@ -584,7 +555,7 @@ void IPMB_TXTask(void *pvParameters, void *arvg0, void *arvg1)
 		}
 
 	cleanup:
-		SAFE_FREE(current_msg_tx);
+		SAFE_IPMI_MSG_FREE(current_msg_tx);
 		k_msleep(IPMB_POLLING_TIME_MS);
 	}
 }
@@ -596,7 +567,7 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 	struct ipmi_msg_cfg *current_msg_rx;
 	struct IPMB_config ipmb_cfg;
 	struct ipmb_msg *ipmb_msg = NULL;
-	uint8_t *ipmb_buffer_rx;
+	uint8_t *frame;
 	uint8_t rx_len;
 	static uint16_t i = 0;
 	int ret;
@@ -608,16 +579,8 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 	}
 
 	while (1) {
-		current_msg_rx = (struct ipmi_msg_cfg *)malloc(sizeof(struct ipmi_msg_cfg));
+		current_msg_rx = (struct ipmi_msg_cfg *)ipmi_msg_pool_alloc(K_FOREVER);
 		if (current_msg_rx == NULL) {
-			k_msleep(10); // allocate fail, retry later
-			continue;
-		}
-		ipmb_buffer_rx =
-			malloc((IPMI_MSG_MAX_LENGTH + IPMB_RESP_HEADER_LENGTH) * sizeof(uint8_t));
-		if (ipmb_buffer_rx == NULL) {
-			SAFE_FREE(current_msg_rx);
-			k_msleep(10); // allocate fail, retry later
 			continue;
 		}
 
@@ -625,8 +588,8 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 		if (ipmb_cfg.interface == I2C_IF) {
 			ret = ipmb_slave_read(dev_ipmb[ipmb_cfg.bus], &ipmb_msg, &rx_len);
 			if (!ret) {
-				memcpy(ipmb_buffer_rx, (uint8_t *)ipmb_msg, rx_len);
-				ipmb_buffer_rx[0] = ipmb_buffer_rx[0] >> 1;
+				// frame stays in the driver buffer, only the payload is copied out
+				frame = (uint8_t *)ipmb_msg;
 			} else {
 				goto cleanup;
 			}
@@ -640,21 +603,20 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 				LOG_DBG("Received an IPMB message from bus(%d) data[%d](",
 					ipmb_cfg.bus, rx_len);
 				for (i = 0; i < rx_len; i++) {
-					LOG_DBG("0x%x ", ipmb_buffer_rx[i + 1]);
+					LOG_DBG("0x%x ", frame[i]);
 				}
 				LOG_DBG(")");
 			}
 
 			/* Perform a checksum test on the message, if it doesn't pass, just ignore
        * it */
-			if (validate_checksum(ipmb_buffer_rx, rx_len) != IPMB_ERROR_SUCCESS) {
+			if (validate_checksum(frame, rx_len) != IPMB_ERROR_SUCCESS) {
 				LOG_ERR("Invalid IPMB message checksum, index(%d)", ipmb_cfg.index);
 				goto cleanup;
 			}
 
-			/* Clear our local buffer before writing new data into it */
 			ipmb_error ret;
-			ret = ipmb_decode(&(current_msg_rx->buffer), ipmb_buffer_rx, rx_len);
+			ret = ipmb_decode(&(current_msg_rx->buffer), frame, rx_len);
 
 			if (ret != IPMB_ERROR_SUCCESS) {
 				LOG_ERR("Failed to decode IPMI message, ret(%d)", ret);
@@ -673,8 +635,7 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 			if (IS_RESPONSE(current_msg_rx->buffer)) { // Response message
 				/* Find the corresponding request message*/
 				current_msg_rx->buffer.seq_target = current_msg_rx->buffer.seq;
-				if (find_req_ipmi_msg(P_start[ipmb_cfg.index],
-						      &(current_msg_rx->buffer), ipmb_cfg.index)) {
+				if (find_req_ipmi_msg(&(current_msg_rx->buffer), ipmb_cfg.index)) {
 					if (DEBUG_IPMB) {
 						LOG_DBG("Found the corresponding request message, from(0x%x) to(0x%x) target_seq_num(%d)",
 							current_msg_rx->buffer.InF_source,
@@ -684,14 +645,7 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 
 					if (current_msg_rx->buffer.InF_source ==
 					    SELF) { // Send from other thread
-						struct ipmi_msg current_msg;
-						current_msg =
-							(struct ipmi_msg)current_msg_rx->buffer;
-						k_msgq_put(
-							&ipmb_rxqueue[IPMB_inf_index_map
-									      [current_msg_rx->buffer
-										       .InF_target]],
-							&current_msg, K_NO_WAIT);
+						// handed to the waiter by find_req_ipmi_msg()
 					} else if ((current_msg_rx->buffer.InF_source & 0xF0) ==
 						   HOST_KCS_1) {
 						// the source is KCS if the bit[7:4] are 0101b.
@@ -701,20 +655,10 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 							    current_msg_rx->buffer.cmd)) {
 							goto cleanup;
 						}
-						uint8_t *kcs_buff;
-						int retry = 0;
-						do {
-							kcs_buff = malloc(KCS_BUFF_SIZE *
-									  sizeof(uint8_t));
-							if (kcs_buff == NULL) {
-								k_msleep(10);
-							} else {
-								break;
-							}
-							retry++;
-						} while (retry < MEM_ALLOCATE_RETRY_TIME);
+						uint8_t *kcs_buff = ipmi_msg_pool_alloc(
+							K_MSEC(10 * MEM_ALLOCATE_RETRY_TIME));
 						if (kcs_buff == NULL) {
-							LOG_ERR("Failed to allocate memory for I2C resp msg");
+							LOG_ERR("Failed to allocate memory for KCS resp msg");
 							goto cleanup;
 						}
 						kcs_buff[0] = current_msg_rx->buffer.netfn << 2;
@@ -732,30 +676,19 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 								  HOST_KCS_1,
 							  kcs_buff,
 							  current_msg_rx->buffer.data_len + 3);
-						SAFE_FREE(kcs_buff);
+						SAFE_IPMI_MSG_FREE(kcs_buff);
 #endif
 					} else if (current_msg_rx->buffer.InF_source == ME_IPMB) {
-						ipmi_msg *bridge_msg =
-							(ipmi_msg *)malloc(sizeof(ipmi_msg));
-						if (bridge_msg == NULL) {
-							LOG_ERR("bridge_msg allocation failed");
-							goto cleanup;
-						}
-						memset(bridge_msg, 0, sizeof(ipmi_msg));
+						// reply to ME with the received message in place
+						ipmi_msg *bridge_msg = &current_msg_rx->buffer;
 
 						bridge_msg->netfn =
-							current_msg_rx->buffer.netfn -
+							bridge_msg->netfn -
 							1; // fix response netfn and would be shift
 						// later in ipmb_send_response
-						bridge_msg->cmd = current_msg_rx->buffer.cmd;
-						bridge_msg->completion_code =
-							current_msg_rx->buffer.completion_code;
-						bridge_msg->seq = current_msg_rx->buffer.seq_source;
-						bridge_msg->data_len =
-							current_msg_rx->buffer.data_len;
-						memcpy(&bridge_msg->data[0],
-						       &current_msg_rx->buffer.data[0],
-						       current_msg_rx->buffer.data_len);
+						bridge_msg->seq = bridge_msg->seq_source;
+						bridge_msg->src_LUN = 0;
+						bridge_msg->dest_LUN = 0;
 
 						if (DEBUG_IPMB) {
 							LOG_DBG("Send the response message to ME, source_seq_num(%d), target_seq_num(%d)",
@@ -771,17 +704,14 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 
 						if (ipmb_send_response(
 							    bridge_msg,
-							    IPMB_inf_index_map[current_msg_rx->buffer
-										       .InF_source]) !=
+							    IPMB_inf_index_map[ME_IPMB]) !=
 						    IPMB_ERROR_SUCCESS) {
 							LOG_ERR("Failed to send IPMB response message");
 						}
-
-						SAFE_FREE(bridge_msg);
 					} else { // Bridge response to other fru
 
 						ipmi_msg *bridge_msg =
-							(ipmi_msg *)malloc(sizeof(ipmi_msg));
+							(ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 						if (bridge_msg == NULL) {
 							LOG_ERR("bridge_msg allocation failed");
 							goto cleanup;
@@ -827,7 +757,7 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 							}
 						}
 
-						SAFE_FREE(bridge_msg);
+						SAFE_IPMI_MSG_FREE(bridge_msg);
 					}
 				}
 
@@ -840,32 +770,26 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
                  * instead of calling IPMI handler.
                  */
 								     current_msg_rx->buffer.cmd))) {
-					ipmi_msg *bridge_msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
-					if (bridge_msg == NULL) {
-						LOG_ERR("bridge_msg allocation failed");
-						goto cleanup;
-					}
-					memset(bridge_msg, 0, sizeof(ipmi_msg));
+					// forward the received message to BMC in place
+					ipmi_msg *bridge_msg = &current_msg_rx->buffer;
+					uint8_t me_netfn = bridge_msg->netfn;
+					uint8_t me_seq = bridge_msg->seq;
 
-					bridge_msg->data_len = current_msg_rx->buffer.data_len;
-					bridge_msg->seq_source = current_msg_rx->buffer.seq;
+					bridge_msg->seq_source = me_seq;
 					bridge_msg->InF_target = BMC_IPMB;
 					bridge_msg->InF_source = ME_IPMB;
-					bridge_msg->netfn = current_msg_rx->buffer.netfn;
-					bridge_msg->cmd = current_msg_rx->buffer.cmd;
-					if (bridge_msg->data_len != 0) {
-						memcpy(&bridge_msg->data[0],
-						       &current_msg_rx->buffer.data[0],
-						       current_msg_rx->buffer.data_len);
-					}
+					bridge_msg->completion_code = 0;
+					bridge_msg->src_LUN = 0;
+					bridge_msg->dest_LUN = 0;
+					bridge_msg->pldm_inst_id = 0;
 
 					// Check BMC communication interface if use IPMB or not
 					if (!pal_is_interface_use_ipmb(
 						    IPMB_inf_index_map[BMC_IPMB])) {
 						// Send ME request to MCTP/PLDM thread to BMC and get response
 						pldm_send_ipmi_request(bridge_msg);
-						bridge_msg->netfn = current_msg_rx->buffer.netfn;
-						bridge_msg->seq = current_msg_rx->buffer.seq;
+						bridge_msg->netfn = me_netfn;
+						bridge_msg->seq = me_seq;
 						// Response to ME
 						if (ipmb_send_response(
 							    bridge_msg,
@@ -880,6 +804,7 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 							    IPMB_inf_index_map[BMC_IPMB]) !=
 						    IPMB_ERROR_SUCCESS) {
 							LOG_ERR("Failed to send the request message to BMC from ME");
+							bridge_msg->seq = me_seq;
 							bridge_msg->completion_code = CC_TIMEOUT;
 							if (ipmb_send_response(
 								    bridge_msg,
@@ -890,8 +815,6 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 							}
 						}
 					}
-
-					SAFE_FREE(bridge_msg);
 				} else {
 					/* The received message is a request
            * Record sequence number for later response
@@ -913,13 +836,13 @@ void IPMB_RXTask(void *pvParameters, void *arvg0, void *arvg1)
 			}
 		}
 	cleanup:
-		SAFE_FREE(current_msg_rx);
-		SAFE_FREE(ipmb_buffer_rx);
+		SAFE_IPMI_MSG_FREE(current_msg_rx);
 		k_msleep(IPMB_POLLING_TIME_MS);
 	}
 }
 
-ipmb_error ipmb_send_request(ipmi_msg *req, uint8_t index)
+static ipmb_error send_request(ipmi_msg *req, uint8_t index, ipmb_waiter *waiter,
+			       uint32_t timeout_ms)
 {
 	CHECK_NULL_ARG_WITH_RETURN(req, IPMB_ERROR_UNKNOWN);
 	CHECK_MSGQ_INIT_WITH_RETURN(&ipmb_txqueue[index], IPMB_ERROR_UNKNOWN);
@@ -949,16 +872,25 @@ ipmb_error ipmb_send_request(ipmi_msg *req, uint8_t index)
 	req_cfg.buffer.seq = get_free_seq(index);
 	req->seq = req_cfg.buffer.seq;
 
+	req_cfg.buffer.seq_target = req_cfg.buffer.seq;
 	req_cfg.buffer.seq_source = req->seq_source;
 	req_cfg.buffer.src_LUN = 0;
 	req_cfg.buffer.pldm_inst_id = req->pldm_inst_id;
 	req_cfg.retries = 0;
 
+	/* Record the request before it is queued so the response can never beat it */
+	ret = insert_req_ipmi_msg(&req_cfg.buffer, index, waiter, timeout_ms);
+	if (ret != IPMB_ERROR_SUCCESS) {
+		k_mutex_unlock(&mutex_send_req);
+		return ret;
+	}
+
 	LOG_DBG("Send req message, index(%d) cc(0x%x) data[%d]:", index,
 		req_cfg.buffer.completion_code, req_cfg.buffer.data_len);
 	LOG_HEXDUMP_DBG(req_cfg.buffer.data, req_cfg.buffer.data_len, "");
 
 	if (k_msgq_put(&ipmb_txqueue[index], &req_cfg, K_MSEC(1000)) != osOK) {
+		clear_req_ipmi_msg(&req_cfg.buffer, index);
 		k_mutex_unlock(&mutex_send_req);
 		return IPMB_ERROR_FAILURE;
 	}
@@ -966,6 +898,11 @@ ipmb_error ipmb_send_request(ipmi_msg *req, uint8_t index)
 	return IPMB_ERROR_SUCCESS;
 }
 
+ipmb_error ipmb_send_request(ipmi_msg *req, uint8_t index)
+{
+	return send_request(req, index, NULL, IPMB_SEQ_TIMEOUT_MS);
+}
+
 ipmb_error ipmb_send_response(ipmi_msg *resp, uint8_t index)
 {
 	CHECK_NULL_ARG_WITH_RETURN(resp, IPMB_ERROR_UNKNOWN);
@@ -1014,42 +951,51 @@ ipmb_error ipmb_send_response(ipmi_msg *resp, uint8_t index)
 	return IPMB_ERROR_SUCCESS;
 }
 
-ipmb_error ipmb_read(ipmi_msg *msg, uint8_t index)
+/* Send a request and wait up to timeout_ms for its response, which is written back to msg.
+ * Each caller waits on its own sequence number, so requests from different threads and
+ * interfaces are in flight at the same time.
+ */
+ipmb_error ipmb_read_timeout(ipmi_msg *msg, uint8_t index, uint32_t timeout_ms)
 {
 	CHECK_NULL_ARG_WITH_RETURN(msg, IPMB_ERROR_UNKNOWN);
-	CHECK_MSGQ_INIT_WITH_RETURN(&ipmb_rxqueue[index], IPMB_ERROR_UNKNOWN);
-	CHECK_MUTEX_INIT_WITH_RETURN(&mutex_read, IPMB_ERROR_UNKNOWN);
-
-	// Set mutex timeout 10ms more than messageQueue timeout, prevent mutex
-	// timeout before messageQueue
-	if (k_mutex_lock(&mutex_read, K_MSEC(IPMB_SEQ_TIMEOUT_MS + 10))) {
-		LOG_ERR("Failed to lock mutex in time, netfn0x%02x cmd0x%02x", msg->netfn,
-			msg->cmd);
-		return IPMB_ERROR_MUTEX_LOCK;
-	}
+	CHECK_MUTEX_INIT_WITH_RETURN(&mutex_id[index], IPMB_ERROR_UNKNOWN);
 
-	// Reset a Message Queue to initialize empty state
-	k_msgq_purge(&ipmb_rxqueue[index]);
+	ipmb_waiter waiter;
+	k_sem_init(&waiter.sem, 0, 1);
+	waiter.msg = msg;
+	waiter.ret = IPMB_ERROR_GET_MESSAGE_QUEUE;
 
-	ipmb_error ret = IPMB_ERROR_SUCCESS;
-	if (ipmb_send_request(msg, index) != IPMB_ERROR_SUCCESS) {
+	if (send_request(msg, index, &waiter, timeout_ms) != IPMB_ERROR_SUCCESS) {
 		LOG_ERR("Failed to send IPMB request message, netfn0x%02x cmd0x%02x", msg->netfn,
 			msg->cmd);
-		ret = IPMB_ERROR_FAILURE;
-		goto exit;
+		return IPMB_ERROR_FAILURE;
+	}
+
+	uint8_t netfn = msg->netfn;
+	uint8_t cmd = msg->cmd;
+	uint8_t seq = msg->seq;
+
+	if (k_sem_take(&waiter.sem, K_MSEC(timeout_ms))) {
+		/* Detach from the table, unless the response landed after the timeout and
+		 * before the lock */
+		k_mutex_lock(&mutex_id[index], K_FOREVER);
+		if (pending_req[index][seq].waiter == &waiter) {
+			pending_req[index][seq].waiter = NULL;
+			pending_req[index][seq].is_valid = false;
+		}
+		k_mutex_unlock(&mutex_id[index]);
 	}
 
-	if (k_msgq_get(&ipmb_rxqueue[index], (ipmi_msg *)msg, K_MSEC(IPMB_SEQ_TIMEOUT_MS))) {
-		LOG_ERR("Failed to get IPMB message from RX queue, netfn0x%02x cmd0x%02x seq%d",
-			msg->netfn, msg->cmd, msg->seq);
-		clear_req_ipmi_msg(P_start[index], (ipmi_msg *)msg, index);
-		ret = IPMB_ERROR_GET_MESSAGE_QUEUE;
-		goto exit;
+	if (waiter.ret != IPMB_ERROR_SUCCESS) {
+		LOG_ERR("Failed to get IPMB response, netfn0x%02x cmd0x%02x seq%d ret%d", netfn,
+			cmd, seq, waiter.ret);
 	}
+	return waiter.ret;
+}
 
-exit:
-	k_mutex_unlock(&mutex_read);
-	return ret;
+ipmb_error ipmb_read(ipmi_msg *msg, uint8_t index)
+{
+	return ipmb_read_timeout(msg, index, IPMB_SEQ_TIMEOUT_MS);
 }
 
 // Send message to IPMI message queue
@@ -1059,11 +1005,8 @@ ipmb_error ipmb_notify_client(ipmi_msg_cfg *msg_cfg)
 
 	/* Sends only the ipmi msg, not the control struct */
 	if (!IS_RESPONSE(msg_cfg->buffer)) {
-		while (k_msgq_put(&ipmi_msgq, msg_cfg, K_NO_WAIT) != 0) {
-			/* message queue is full: purge old data & try again */
-			k_msgq_purge(&ipmi_msgq);
-			LOG_INF("Retry to send message to IPMI message queue");
-		}
+		/* requester gets node busy if the queue is full */
+		ipmi_msgq_put(msg_cfg, K_NO_WAIT);
 	}
 	return IPMB_ERROR_SUCCESS;
 }
@@ -1094,6 +1037,7 @@ ipmb_error ipmb_encode(uint8_t *buffer, ipmi_msg *msg)
 	return IPMB_ERROR_SUCCESS;
 }
 
+/* Decode a frame from the IPMB slave driver buffer in place, only the payload is copied */
 ipmb_error ipmb_decode(ipmi_msg *msg, uint8_t *buffer, uint8_t len)
 {
 	CHECK_NULL_ARG_WITH_RETURN(buffer, IPMB_ERROR_UNKNOWN);
@@ -1102,7 +1046,7 @@ ipmb_error ipmb_decode(ipmi_msg *msg, uint8_t *buffer, uint8_t len)
 	/* Use this variable to address the buffer dynamically */
 	uint8_t i = 0;
 
-	msg->dest_addr = buffer[i++];
+	msg->dest_addr = buffer[i++] >> 1;
 	msg->netfn = buffer[i] >> 2;
 	msg->dest_LUN = (buffer[i++] & IPMB_DEST_LUN_MASK);
 	msg->hdr_chksum = buffer[i++];
@@ -1122,49 +1066,50 @@ ipmb_error ipmb_decode(ipmi_msg *msg, uint8_t *buffer, uint8_t len)
 	return IPMB_ERROR_SUCCESS;
 }
 
-void IPMB_SeqTimeout_handler(void *arug0, void *arug1, void *arug2)
+/* Release the sequence numbers of requests which got no response in IPMB_SEQ_TIMEOUT_MS, then
+ * re-arm for the earliest deadline left */
+static void ipmb_seq_timeout_handler(struct k_work *work)
 {
-	ipmi_msg_cfg *pnode;
-	int ret;
-	uint8_t index;
-	uint32_t current_time;
+	ARG_UNUSED(work);
 
-	while (1) {
-		k_msleep(IPMB_SEQ_TIMEOUT_MS);
-		for (index = 0; index < MAX_IPMB_IDX; index++) {
-			if (!IPMB_config_table[index].enable_status) {
-				continue;
-			}
+	// requests inserted from here on re-arm for their own deadline
+	k_mutex_lock(&mutex_seq_timeout, K_FOREVER);
+	seq_timeout_deadline = 0;
+	k_mutex_unlock(&mutex_seq_timeout);
 
-			ret = k_mutex_lock(&mutex_id[index], K_MSEC(1000));
+	int64_t now = k_uptime_get();
+	int64_t next_deadline = 0;
+	uint8_t index, seq;
 
-			if (ret) {
-				LOG_ERR("Failed to lock the mutex, ret(%d)", ret);
-			} else {
-				pnode = P_start[index];
-				while (pnode->next != P_start[index]) {
-					current_time = osKernelGetSysTimerCount();
-					// The queue stay more than 1000 ms need to be killed
-					if (current_time + tick_fix -
-							    ((pnode->next)->buffer.timestamp) >
-						    (IPMB_SEQ_TIMEOUT_MS / 1000) * sys_tick_freq ||
-					    (current_time + tick_fix -
-					     ((pnode->next)->buffer.timestamp)) &
-						    0x80000000) {
-						ipmi_msg_cfg *temp;
-						temp = pnode->next;
-						pnode->next = temp->next;
-						unregister_seq(index, temp->buffer.seq_target);
-						SAFE_FREE(temp);
-						seq_current_count[index]--;
-					}
+	for (index = 0; index < MAX_IPMB_IDX; index++) {
+		if (!IPMB_config_table[index].enable_status) {
+			continue;
+		}
 
-					pnode = pnode->next;
-				}
+		if (k_mutex_lock(&mutex_id[index], K_NO_WAIT)) {
+			// table is busy, try again later instead of blocking the workqueue
+			next_deadline = now + IPMB_SEQ_TIMEOUT_RETRY_MS;
+			continue;
+		}
 
-				k_mutex_unlock(&mutex_id[index]);
+		for (seq = 0; seq < SEQ_NUM; seq++) {
+			ipmb_pending_req *req = &pending_req[index][seq];
+			if (!req->is_valid) {
+				continue;
+			}
+
+			if (req->deadline <= now) {
+				complete_req(req, IPMB_ERROR_GET_MESSAGE_QUEUE);
+			} else if ((next_deadline == 0) || (req->deadline < next_deadline)) {
+				next_deadline = req->deadline;
 			}
 		}
+
+		k_mutex_unlock(&mutex_id[index]);
+	}
+
+	if (next_deadline) {
+		arm_seq_timeout(next_deadline);
 	}
 }
 
@@ -1229,16 +1174,7 @@ void create_ipmb_threads(uint8_t index)
 
 	memset(&IPMB_TxTask_attr, 0, sizeof(IPMB_TxTask_attr));
 	memset(&IPMB_RxTask_attr, 0, sizeof(IPMB_RxTask_attr));
-	memset(&seq_table[index], 0, sizeof(bool) * SEQ_NUM);
-
-	P_start[index] = (void *)malloc(sizeof(struct ipmi_msg_cfg));
-	if (P_start[index] == NULL) {
-		LOG_ERR("Memory allocation failed!");
-		return;
-	}
-
-	P_temp = P_start[index];
-	P_temp->next = P_temp;
+	memset(&pending_req[index], 0, sizeof(pending_req[index]));
 
 	int i = 0, retry = 3;
 	for (i = 0; i <= retry; ++i) {
@@ -1255,8 +1191,6 @@ void create_ipmb_threads(uint8_t index)
 
 	k_msgq_init(&ipmb_txqueue[index], ipmb_txqueue_buffer[index], sizeof(struct ipmi_msg_cfg),
 		    IPMB_TXQUEUE_LEN);
-	k_msgq_init(&ipmb_rxqueue[index], ipmb_rxqueue_buffer[index], sizeof(struct ipmi_msg),
-		    IPMB_RXQUEUE_LEN);
 
 	IPMB_TX_ID[index] =
 		k_thread_create(&IPMB_TX[index], ipmb_tx_stacks[index], IPMB_TX_STACK_SIZE,
@@ -1326,10 +1260,6 @@ void ipmb_init(void)
 
 	memset(&current_seq, 0, sizeof(uint8_t) * MAX_IPMB_IDX);
 
-	// Get the RTOS kernel system timer
-	sys_tick_freq = osKernelGetSysTimerFreq();
-	tick_fix = sys_tick_freq / 1000;
-
 	// Initial mutex
 	if (k_mutex_init(&mutex_send_req)) {
 		LOG_ERR(" Failed to initialize IPMB send request mutex");
@@ -1337,9 +1267,6 @@ void ipmb_init(void)
 	if (k_mutex_init(&mutex_send_res)) {
 		LOG_ERR("Failed to initialize IPMB send response mutex");
 	}
-	if (k_mutex_init(&mutex_read)) {
-		LOG_ERR("Failed to initialize IPMB read mutex");
-	}
 
 	// Create IPMB threads for each index
 	for (index = 0; index < MAX_IPMB_IDX; index++) {
@@ -1347,11 +1274,5 @@ void ipmb_init(void)
 			create_ipmb_threads(index);
 		}
 	}
-
-	// Create IPMB sequence number timeout thread
-	k_thread_create(&IPMB_SeqTimeout, IPMB_SeqTimeout_stack,
-			K_THREAD_STACK_SIZEOF(IPMB_SeqTimeout_stack), IPMB_SeqTimeout_handler, NULL,
-			NULL, NULL, CONFIG_MAIN_THREAD_PRIORITY, 0, K_NO_WAIT);
-	k_thread_name_set(&IPMB_SeqTimeout, "IPMB_SeqTimeout");
 }
 #endif
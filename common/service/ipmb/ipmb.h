@@ -63,7 +63,6 @@
 #define DEBUG_IPMB 0
 
 #define SEQ_NUM 64
-#define MAX_SEQ_QUENE 15
 #define MEM_ALLOCATE_RETRY_TIME 2
 #define IPMI_DATA_MAX_LENGTH 520
 #define IPMB_REQ_HEADER_LENGTH 6
@@ -71,7 +70,6 @@
 #define IPMI_MSG_MAX_LENGTH (IPMI_DATA_MAX_LENGTH + IPMB_RESP_HEADER_LENGTH)
 #define IPMB_TX_RETRY_TIME 5
 #define IPMB_TXQUEUE_LEN 1
-#define IPMB_RXQUEUE_LEN 2
 #define IPMB_TX_STACK_SIZE 3072
 #define IPMB_RX_STACK_SIZE 3072
 #define IPMI_HEADER_CHECKSUM_POSITION 2
@@ -82,7 +80,7 @@
 #define IPMB_RETRY_DELAY_MS 500
 #define IPMB_POLLING_TIME_MS 1
 #define IPMB_SEQ_TIMEOUT_MS 3000
-#define IPMB_SEQ_TIMEOUT_STACK_SIZE 512
+#define IPMB_SEQ_TIMEOUT_RETRY_MS 10
 #define I2C_RETRY_TIME 5
 
 #define RESERVED_IDX 0xFF
@@ -184,7 +182,6 @@ typedef struct ipmi_msg {
 typedef struct ipmi_msg_cfg {
 	ipmi_msg buffer; /**< IPMI Message */
 	uint8_t retries; /**< Current retry counter */
-	struct ipmi_msg_cfg *next;
 } __attribute__((packed, aligned(4))) ipmi_msg_cfg;
 
 bool pal_load_ipmb_config(void);
@@ -193,6 +190,7 @@ void ipmb_init(void);
 ipmb_error ipmb_send_request(ipmi_msg *req, uint8_t index);
 ipmb_error ipmb_send_response(ipmi_msg *resp, uint8_t index);
 ipmb_error ipmb_read(ipmi_msg *msg, uint8_t bus);
+ipmb_error ipmb_read_timeout(ipmi_msg *msg, uint8_t index, uint32_t timeout_ms);
 void ipmb_tx_suspend(uint8_t index);
 void ipmb_tx_resume(uint8_t index);
 
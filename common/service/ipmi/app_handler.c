@@ -15,6 +15,7 @@
  */
 
 #include "app_handler.h"
+#include "ipmi_cmd_table.h"
 
 #include "fru.h"
 #include "sdr.h"
@@ -218,37 +219,19 @@ __weak void APP_MASTER_WRITE_READ(ipmi_msg *msg)
 	return;
 }
 
-void IPMI_APP_handler(ipmi_msg *msg)
-{
-	CHECK_NULL_ARG(msg);
-
-	switch (msg->cmd) {
-	case CMD_APP_GET_DEVICE_ID:
-		APP_GET_DEVICE_ID(msg);
-		break;
-	case CMD_APP_COLD_RESET:
-		APP_COLD_RESET(msg);
-		break;
-	case CMD_APP_WARM_RESET:
-		APP_WARM_RESET(msg);
-		break;
-	case CMD_APP_GET_SELFTEST_RESULTS:
-		APP_GET_SELFTEST_RESULTS(msg);
-		break;
-	case CMD_APP_MASTER_WRITE_READ:
-		APP_MASTER_WRITE_READ(msg);
-		break;
+static const ipmi_cmd_entry app_cmd_table[] = {
+	{ CMD_APP_GET_DEVICE_ID, APP_GET_DEVICE_ID },
+	{ CMD_APP_COLD_RESET, APP_COLD_RESET, IPMI_CMD_CLASS_FAST, 0, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_APP_WARM_RESET, APP_WARM_RESET, IPMI_CMD_CLASS_FAST, 0, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_APP_GET_SELFTEST_RESULTS, APP_GET_SELFTEST_RESULTS },
+	{ CMD_APP_MASTER_WRITE_READ, APP_MASTER_WRITE_READ,
+	  IPMI_CMD_CLASS_DEVICE, 4, IPMI_CMD_PRIV_ADMIN },
 #ifdef CONFIG_ESPI
-	case CMD_APP_GET_SYSTEM_GUID:
-		APP_GET_SYSTEM_GUID(msg);
-		break;
+	{ CMD_APP_GET_SYSTEM_GUID, APP_GET_SYSTEM_GUID },
 #endif
-	default:
-		LOG_ERR("Invalid APP msg netfn: %x, cmd: %x", msg->netfn, msg->cmd);
-		msg->data_len = 0;
-		msg->completion_code = CC_INVALID_CMD;
-		break;
-	}
+};
 
-	return;
+void app_cmd_register(void)
+{
+	ipmi_cmd_register_table(NETFN_APP_REQ, app_cmd_table, ARRAY_SIZE(app_cmd_table));
 }
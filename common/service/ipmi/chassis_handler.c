@@ -15,6 +15,7 @@
  */
 
 #include "chassis_handler.h"
+#include "ipmi_cmd_table.h"
 
 #include "power_status.h"
 #include <logging/log.h>
@@ -45,21 +46,14 @@ __weak void CHASSIS_GET_CHASSIS_STATUS(ipmi_msg *msg)
 }
 #endif
 
-void IPMI_CHASSIS_handler(ipmi_msg *msg)
-{
-	CHECK_NULL_ARG(msg);
-
-	switch (msg->cmd) {
+static const ipmi_cmd_entry chassis_cmd_table[] = {
 #ifdef CONFIG_ESPI
-	case CMD_CHASSIS_GET_CHASSIS_STATUS:
-		CHASSIS_GET_CHASSIS_STATUS(msg);
-		break;
+	{ CMD_CHASSIS_GET_CHASSIS_STATUS, CHASSIS_GET_CHASSIS_STATUS },
 #endif
-	default:
-		LOG_ERR("Invalid chassis msg netfn: %x, cmd: %x", msg->netfn, msg->cmd);
-		msg->data_len = 0;
-		msg->completion_code = CC_INVALID_CMD;
-		break;
-	}
-	return;
+};
+
+void chassis_cmd_register(void)
+{
+	ipmi_cmd_register_table(NETFN_CHASSIS_REQ, chassis_cmd_table,
+				ARRAY_SIZE(chassis_cmd_table));
 }
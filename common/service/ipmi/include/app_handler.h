@@ -51,6 +51,6 @@ void APP_MASTER_WRITE_READ(ipmi_msg *msg);
 void APP_GET_SYSTEM_GUID(ipmi_msg *msg);
 #endif
 
-void IPMI_APP_handler(ipmi_msg *msg);
+void app_cmd_register(void);
 
 #endif
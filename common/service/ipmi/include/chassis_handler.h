@@ -65,6 +65,6 @@ typedef struct CHASSIS_STATUS_STRUCT {
 void CHASSIS_GET_CHASSIS_STATUS(ipmi_msg *msg);
 #endif
 
-void IPMI_CHASSIS_handler(ipmi_msg *msg);
+void chassis_cmd_register(void);
 
 #endif
@@ -23,6 +23,16 @@
 
 #define IPMI_THREAD_STACK_SIZE 4096
 #define IPMI_BUF_LEN 10
+/* Worker threads for the non-fast command classes, every command is handled in IPMI_thread
+ * unless the platform defines IPMI_WORKER_NUM, up to IPMI_CMD_CLASS_MAX - 1.
+ */
+#ifndef IPMI_WORKER_NUM
+#define IPMI_WORKER_NUM 0
+#endif
+#define IPMI_WORKER_STACK_SIZE 4096
+#define IPMI_WORKER_QUEUE_LEN 2
+/* Requests one source could have in ipmi_msgq, requests over it get CC_NODE_BUSY */
+#define IPMI_SOURCE_QUEUE_LEN_DEFAULT 4
 #ifndef IANA_ID
 #define IANA_ID 0x00A015 // Meta's IANA
 #endif
@@ -31,6 +41,35 @@
 #define SENSOR_SCANNING_ENABLE (1 << 6)
 #define SENSOR_READING_STATE_UNAVAILABLE (1 << 5)
 
+enum IPMI_CMD_CLASS {
+	IPMI_CMD_CLASS_FAST, // handled in IPMI_thread
+	IPMI_CMD_CLASS_DEVICE, // access devices on bus, e.g. PECI, APML, JTAG, I2C
+	IPMI_CMD_CLASS_LONG, // firmware update and flash access
+	IPMI_CMD_CLASS_MAX,
+};
+
+#define IPMI_SOURCE_KCS_NUM (HOST_KCS_4 - HOST_KCS_1 + 1)
+
+/* ipmi_msgq admission buckets, each KCS channel and each IPMB interface of IPMB_config_table
+ * has its own, so a burst from one channel (e.g. BMC) never starves another one (e.g. ME).
+ */
+enum IPMI_SOURCE {
+	IPMI_SOURCE_SELF,
+	IPMI_SOURCE_USB,
+	IPMI_SOURCE_PLDM,
+	IPMI_SOURCE_OTHER, // channels not listed in IPMB_config_table
+	IPMI_SOURCE_KCS, // first of IPMI_SOURCE_KCS_NUM
+	IPMI_SOURCE_IPMB = IPMI_SOURCE_KCS + IPMI_SOURCE_KCS_NUM, // first of MAX_IPMB_IDX
+};
+
+typedef struct _ipmi_msgq_stat {
+	uint8_t channel; // InF_source of the bucket, RESERVED for IPMI_SOURCE_OTHER
+	uint32_t queued; // requests waiting in ipmi_msgq now
+	uint32_t accepted;
+	uint32_t rejected; // answered with CC_NODE_BUSY
+	uint32_t dropped; // not admitted and no response could be sent
+} ipmi_msgq_stat;
+
 extern uint8_t IPMB_inf_index_map[];
 extern uint8_t isPwOn;
 extern struct k_msgq ipmi_msgq;
@@ -80,8 +119,11 @@ bool pal_request_msg_to_BIC_from_ME(uint8_t netfn, uint8_t cmd);
 // For the command that BIC only bridges it, BIC doesn't return the command directly
 // For this kind of commands we return through IPMB that receiving the responses from the other devices.
 bool pal_is_not_return_cmd(uint8_t netfn, uint8_t cmd);
+uint8_t pal_get_ipmi_cmd_class(uint8_t netfn, uint8_t cmd);
 bool common_add_sel_evt_record(common_addsel_msg_t *sel_msg);
 void ipmi_init(void);
+int ipmi_msgq_put(ipmi_msg_cfg *msg_cfg, k_timeout_t timeout);
+bool get_ipmi_msgq_stat(uint8_t source, ipmi_msgq_stat *stat);
 void IPMI_handler(void *arug0, void *arug1, void *arug2);
 
 enum {
@@ -100,6 +142,7 @@ enum {
 	CC_SENSOR_NOT_PRESENT = 0xCB,
 	CC_INVALID_DATA_FIELD = 0xCC,
 	CC_CAN_NOT_RESPOND = 0xCE,
+	CC_INSUFFICIENT_PRIVILEGE = 0xD4,
 	CC_NOT_SUPP_IN_CURR_STATE = 0xD5,
 	CC_UNSPECIFIED_ERROR = 0xFF,
 
@@ -263,6 +306,9 @@ enum {
 	CMD_OEM_1S_GET_PCIE_CARD_SENSOR_READING = 0x77,
 
 	CMD_OEM_1S_MULTI_ACCURACY_SENSOR_READING = 0x88,
+	CMD_OEM_1S_GET_SENSOR_HISTORY = 0x89,
+	CMD_OEM_1S_GET_IPMI_CMD_STAT = 0x8A,
+	CMD_OEM_1S_FW_UPDATE_STREAM = 0x8B,
 	CMD_OEM_1S_GET_BOARD_ID = 0xA0,
 	CMD_OEM_1S_GET_CARD_TYPE = 0xA1,
 	CMD_OEM_1S_GET_BIOS_VERSION = 0xA2,
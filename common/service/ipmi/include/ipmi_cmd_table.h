@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IPMI_CMD_TABLE_H
+#define IPMI_CMD_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ipmi.h"
+
+/* Max number of registered netfn/cmd pairs, must be a power of 2 */
+#define IPMI_CMD_TABLE_SIZE_DEFAULT 128
+
+/* Max number of command statistics returned by one OEM query, each takes
+ * IPMI_CMD_STAT_QUERY_ENTRY_SIZE bytes. Keep the response (IANA + 3 + entries) within what
+ * IPMB (uint8_t frame length) and KCS (KCS_BUFF_SIZE) could carry.
+ */
+#define IPMI_CMD_STAT_QUERY_MAX 10
+#define IPMI_CMD_STAT_QUERY_ENTRY_SIZE 22
+
+typedef void (*ipmi_cmd_handler_fn)(ipmi_msg *msg);
+
+enum IPMI_CMD_PRIVILEGE {
+	IPMI_CMD_PRIV_USER, // read only or harmless commands
+	IPMI_CMD_PRIV_ADMIN, // resets, firmware/register writes and raw device access
+};
+
+typedef struct _ipmi_cmd_entry {
+	uint8_t cmd;
+	ipmi_cmd_handler_fn handler; // NULL to accept the command without response data
+	uint8_t cmd_class; // IPMI_CMD_CLASS, fast if not given
+	uint8_t min_data_len; // shorter requests get CC_INVALID_LENGTH
+	uint8_t privilege; // IPMI_CMD_PRIVILEGE, user if not given
+} ipmi_cmd_entry;
+
+typedef struct _ipmi_cmd_stat {
+	uint8_t netfn;
+	uint8_t cmd;
+	uint32_t count;
+	uint32_t error; // completion code other than CC_SUCCESS
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t total_us;
+} ipmi_cmd_stat;
+
+void ipmi_cmd_table_init(void);
+bool ipmi_cmd_register_table(uint8_t netfn, const ipmi_cmd_entry *table, uint8_t count);
+void ipmi_cmd_dispatch(ipmi_msg *msg);
+uint8_t ipmi_cmd_get_class(uint8_t netfn, uint8_t cmd);
+uint16_t get_ipmi_cmd_count(void);
+bool get_ipmi_cmd_stat(uint16_t index, ipmi_cmd_stat *stat);
+void clear_ipmi_cmd_stat(void);
+void pal_register_ipmi_cmd(void);
+uint8_t pal_get_ipmi_source_privilege(uint8_t InF_source);
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IPMI_MSG_POOL_H
+#define IPMI_MSG_POOL_H
+
+#include <zephyr.h>
+#include "ipmb.h"
+
+/* Number of message buffers, platform could define IPMI_MSG_POOL_NUM to resize the pool.
+ * Each IPMB RX task keeps one buffer, a TX task takes two only while sending, the rest are for
+ * bridging.
+ */
+#define IPMI_MSG_POOL_NUM_DEFAULT 24
+
+/* A buffer holds an ipmi_msg_cfg, so it could also be used for an ipmi_msg, a KCS buffer, an
+ * I2C_MSG or a raw IPMB frame.
+ */
+#define IPMI_MSG_POOL_BUF_SIZE sizeof(ipmi_msg_cfg)
+
+#define SAFE_IPMI_MSG_FREE(p)                                                                      \
+	if (p) {                                                                                   \
+		ipmi_msg_pool_free(p);                                                             \
+		p = NULL;                                                                          \
+	}
+
+typedef struct _ipmi_msg_pool_stat {
+	uint32_t total;
+	uint32_t used;
+	uint32_t max_used; // high water mark since boot
+	uint32_t alloc_fail;
+} ipmi_msg_pool_stat;
+
+void *ipmi_msg_pool_alloc(k_timeout_t timeout);
+void ipmi_msg_pool_free(void *buf);
+void get_ipmi_msg_pool_stat(ipmi_msg_pool_stat *stat);
+
+#endif
@@ -54,6 +54,9 @@ enum FIRWARE_UPDATE_TARGET {
 	PRoT_FLASH_UPDATE,
 };
 
+#define BIOS_UPDATE_MAX_OFFSET 0x4000000
+#define BIC_UPDATE_MAX_OFFSET 0x50000
+
 #define GLOBAL_GPIO_IDX_KEY 0xFF
 enum GET_SET_GPIO_OPTIONS {
 	GET_GPIO_STATUS = 0,
@@ -70,6 +73,8 @@ enum GET_SET_VGPIO_OPTIONS {
 typedef struct _ACCURACY_SENSOR_READING_REQ {
 	uint8_t sensor_num;
 	uint8_t read_option;
+	/* optional, read from sensor if the cache is older than this with GET_FROM_CACHE */
+	uint16_t max_age_ms;
 } ACCURACY_SENSOR_READING_REQ;
 
 typedef struct _ACCURACY_SENSOR_READING_RES {
@@ -93,6 +98,8 @@ void OEM_1S_RESET_BMC(ipmi_msg *msg);
 void OEM_1S_READ_FW_IMAGE(ipmi_msg *msg);
 void OEM_1S_SENSOR_POLL_EN(ipmi_msg *msg);
 void OEM_1S_ACCURACY_SENSOR_READING(ipmi_msg *msg);
+void OEM_1S_GET_SENSOR_HISTORY(ipmi_msg *msg);
+void OEM_1S_GET_IPMI_CMD_STAT(ipmi_msg *msg);
 void OEM_1S_GET_SET_GPIO(ipmi_msg *msg);
 void OEM_1S_GET_SET_BIC_VGPIO(ipmi_msg *msg);
 void OEM_1S_GET_FW_SHA256(ipmi_msg *msg);
@@ -153,6 +160,6 @@ void OEM_1S_GET_FAN_RPM(ipmi_msg *msg);
 void OEM_1S_WRITE_READ_DIMM(ipmi_msg *msg);
 #endif
 
-void IPMI_OEM_1S_handler(ipmi_msg *msg);
+void oem_1s_cmd_register(void);
 
 #endif
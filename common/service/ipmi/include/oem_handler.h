@@ -34,6 +34,6 @@ void OEM_GET_SET_FAN_CTRL_MODE(ipmi_msg *msg);
 
 void OEM_GET_MB_INDEX(ipmi_msg *msg);
 void OEM_CABLE_DETECTION(ipmi_msg *msg);
-void IPMI_OEM_handler(ipmi_msg *msg);
+void oem_cmd_register(void);
 
 #endif
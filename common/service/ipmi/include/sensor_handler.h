@@ -23,6 +23,6 @@
 
 void SENSOR_GET_SENSOR_READING(ipmi_msg *msg);
 
-void IPMI_SENSOR_handler(ipmi_msg *msg);
+void sensor_cmd_register(void);
 
 #endif
@@ -55,6 +55,6 @@ void STORAGE_RSV_SDR(ipmi_msg *msg);
 void STORAGE_GET_SDR(ipmi_msg *msg);
 void STORAGE_ADD_SEL(ipmi_msg *msg);
 
-void IPMI_Storage_handler(ipmi_msg *msg);
+void storage_cmd_register(void);
 
 #endif
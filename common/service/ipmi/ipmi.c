@@ -20,6 +20,9 @@
 #include <logging/log.h>
 #include "cmsis_os2.h"
 #include "ipmi.h"
+#include "ipmi_cmd_table.h"
+#include "ipmi_msg_pool.h"
+#include "hal_i2c.h"
 
 #ifdef CONFIG_IPMI_KCS_ASPEED
 #include "kcs.h"
@@ -43,6 +46,12 @@ LOG_MODULE_REGISTER(ipmi);
 
 #define IPMI_QUEUE_SIZE 5
 
+#ifndef IPMI_SOURCE_QUEUE_LEN
+#define IPMI_SOURCE_QUEUE_LEN IPMI_SOURCE_QUEUE_LEN_DEFAULT
+#endif
+
+#define IPMI_SOURCE_MAX (IPMI_SOURCE_IPMB + MAX_IPMB_IDX)
+
 struct k_thread IPMI_thread;
 K_KERNEL_STACK_MEMBER(IPMI_thread_stack, IPMI_THREAD_STACK_SIZE);
 
@@ -51,6 +60,12 @@ struct k_msgq ipmi_msgq;
 char __aligned(4) self_ipmi_msgq_buffer[1 * sizeof(struct ipmi_msg_cfg)];
 struct k_msgq self_ipmi_msgq;
 
+/* Free ipmi_msgq entries left for each source */
+static struct k_sem ipmi_source_sem[IPMI_SOURCE_MAX];
+static atomic_t ipmi_source_accepted[IPMI_SOURCE_MAX];
+static atomic_t ipmi_source_rejected[IPMI_SOURCE_MAX];
+static atomic_t ipmi_source_dropped[IPMI_SOURCE_MAX];
+
 __weak uint32_t get_iana(uint8_t *iana_buf)
 {
 	CHECK_NULL_ARG_WITH_RETURN(iana_buf, 0);
@@ -177,9 +192,9 @@ bool common_add_sel_evt_record(common_addsel_msg_t *sel_msg)
 	static uint16_t record_id = 0x1;
 	uint8_t system_event_record = 0x02;
 	uint8_t evt_msg_version = 0x04;
-	ipmi_msg *msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+	ipmi_msg *msg = (ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 	if (msg == NULL) {
-		LOG_ERR("Add sel msg malloc fail");
+		LOG_ERR("Add sel msg allocate fail");
 		return false;
 	}
 	memset(msg, 0, sizeof(ipmi_msg));
@@ -222,173 +237,324 @@ bool common_add_sel_evt_record(common_addsel_msg_t *sel_msg)
 		break;
 	}
 
-	SAFE_FREE(msg);
+	SAFE_IPMI_MSG_FREE(msg);
 	return ipmb_flag;
 }
 
-void IPMI_handler(void *arug0, void *arug1, void *arug2)
+__weak uint8_t pal_get_ipmi_cmd_class(uint8_t netfn, uint8_t cmd)
 {
-	ipmi_msg_cfg msg_cfg;
-
-	while (1) {
-		uint32_t iana = 0;
-		memset(&msg_cfg, 0, sizeof(ipmi_msg_cfg));
-		k_msgq_get(&ipmi_msgq, &msg_cfg, K_FOREVER);
+	return ipmi_cmd_get_class(netfn, cmd);
+}
 
-		LOG_DBG("IPMI_handler[%d]: netfn: %x", msg_cfg.buffer.data_len,
-			msg_cfg.buffer.netfn);
-		LOG_HEXDUMP_DBG(msg_cfg.buffer.data, msg_cfg.buffer.data_len, "");
-
-		msg_cfg.buffer.completion_code = CC_INVALID_CMD;
-		switch (msg_cfg.buffer.netfn) {
-		case NETFN_CHASSIS_REQ:
-			IPMI_CHASSIS_handler(&msg_cfg.buffer);
-			break;
-		case NETFN_BRIDGE_REQ:
-			// IPMI_BRIDGE_handler();
-			break;
-		case NETFN_SENSOR_REQ:
-			IPMI_SENSOR_handler(&msg_cfg.buffer);
-			break;
-		case NETFN_APP_REQ:
-			IPMI_APP_handler(&msg_cfg.buffer);
-			break;
-		case NETFN_FIRMWARE_REQ:
-			break;
-		case NETFN_STORAGE_REQ:
-			IPMI_Storage_handler(&msg_cfg.buffer);
-			break;
-		case NETFN_TRANSPORT_REQ:
-			break;
-		case NETFN_DCMI_REQ:
-			break;
-		case NETFN_NM_REQ:
-			break;
-		case NETFN_OEM_REQ:
-			IPMI_OEM_handler(&msg_cfg.buffer);
-			break;
-		case NETFN_OEM_1S_REQ:
-			iana = get_iana(msg_cfg.buffer.data);
-			if ((msg_cfg.buffer.data_len >= 3) && (iana != 0)) {
-				msg_cfg.buffer.data_len -= 3;
-				memcpy(&msg_cfg.buffer.data[0], &msg_cfg.buffer.data[3],
-				       msg_cfg.buffer.data_len);
-				IPMI_OEM_1S_handler(&msg_cfg.buffer);
-				break;
-			} else if (pal_is_not_return_cmd(msg_cfg.buffer.netfn,
-							 msg_cfg.buffer.cmd)) {
-				// Due to command not returning to bridge command source,
-				// enter command handler and return with other invalid CC
-				msg_cfg.buffer.completion_code = CC_INVALID_IANA;
-				IPMI_OEM_1S_handler(&msg_cfg.buffer);
-				break;
-			} else {
-				msg_cfg.buffer.completion_code = CC_INVALID_IANA;
-				msg_cfg.buffer.data_len = 0;
-				break;
-			}
-		default: // invalid net function
-			LOG_ERR("invalid msg netfn: %x, cmd: %x", msg_cfg.buffer.netfn,
-				msg_cfg.buffer.cmd);
-			msg_cfg.buffer.data_len = 0;
-			break;
+/* Run the command handler, return the IANA stripped from an OEM 1S request */
+static uint32_t ipmi_cmd_handle(ipmi_msg_cfg *msg_cfg)
+{
+	uint32_t iana = 0;
+
+	LOG_DBG("IPMI_handler[%d]: netfn: %x", msg_cfg->buffer.data_len, msg_cfg->buffer.netfn);
+	LOG_HEXDUMP_DBG(msg_cfg->buffer.data, msg_cfg->buffer.data_len, "");
+
+	msg_cfg->buffer.completion_code = CC_INVALID_CMD;
+	if (msg_cfg->buffer.netfn == NETFN_OEM_1S_REQ) {
+		iana = get_iana(msg_cfg->buffer.data);
+		if ((msg_cfg->buffer.data_len >= 3) && (iana != 0)) {
+			msg_cfg->buffer.data_len -= 3;
+			memcpy(&msg_cfg->buffer.data[0], &msg_cfg->buffer.data[3],
+			       msg_cfg->buffer.data_len);
+		} else if (pal_is_not_return_cmd(msg_cfg->buffer.netfn, msg_cfg->buffer.cmd)) {
+			// Due to command not returning to bridge command source,
+			// enter command handler and return with other invalid CC
+			msg_cfg->buffer.completion_code = CC_INVALID_IANA;
+		} else {
+			msg_cfg->buffer.completion_code = CC_INVALID_IANA;
+			msg_cfg->buffer.data_len = 0;
+			return iana;
 		}
+	}
 
-		if (pal_is_not_return_cmd(msg_cfg.buffer.netfn, msg_cfg.buffer.cmd)) {
-			continue;
-		}
+	ipmi_cmd_dispatch(&msg_cfg->buffer);
 
-		if (msg_cfg.buffer.completion_code != CC_SUCCESS) {
-			msg_cfg.buffer.data_len = 0;
-		} else if (msg_cfg.buffer.netfn == NETFN_OEM_1S_REQ) {
-			uint8_t copy_data[msg_cfg.buffer.data_len];
-			memcpy(&copy_data[0], &msg_cfg.buffer.data[0], msg_cfg.buffer.data_len);
-			memcpy(&msg_cfg.buffer.data[3], &copy_data[0], msg_cfg.buffer.data_len);
-			msg_cfg.buffer.data_len += 3;
-			msg_cfg.buffer.data[0] = iana & 0xFF;
-			msg_cfg.buffer.data[1] = (iana >> 8) & 0xFF;
-			msg_cfg.buffer.data[2] = (iana >> 16) & 0xFF;
-		}
+	return iana;
+}
+
+/* Send the response back to the interface the request came from */
+static void ipmi_send_response(ipmi_msg_cfg *msg_cfg, uint32_t iana)
+{
+	if (pal_is_not_return_cmd(msg_cfg->buffer.netfn, msg_cfg->buffer.cmd)) {
+		return;
+	}
+
+	if (msg_cfg->buffer.completion_code != CC_SUCCESS) {
+		msg_cfg->buffer.data_len = 0;
+	} else if (msg_cfg->buffer.netfn == NETFN_OEM_1S_REQ) {
+		uint8_t copy_data[msg_cfg->buffer.data_len];
+		memcpy(&copy_data[0], &msg_cfg->buffer.data[0], msg_cfg->buffer.data_len);
+		memcpy(&msg_cfg->buffer.data[3], &copy_data[0], msg_cfg->buffer.data_len);
+		msg_cfg->buffer.data_len += 3;
+		msg_cfg->buffer.data[0] = iana & 0xFF;
+		msg_cfg->buffer.data[1] = (iana >> 8) & 0xFF;
+		msg_cfg->buffer.data[2] = (iana >> 16) & 0xFF;
+	}
 
-		switch (msg_cfg.buffer.InF_source) {
+	switch (msg_cfg->buffer.InF_source) {
 #ifdef CONFIG_USB
-		case BMC_USB:
-			usb_write_by_ipmi(&msg_cfg.buffer);
-			break;
+	case BMC_USB:
+		usb_write_by_ipmi(&msg_cfg->buffer);
+		break;
 #endif
 #ifdef CONFIG_IPMI_KCS_ASPEED
-		case HOST_KCS_1:
-		case HOST_KCS_2:
-		case HOST_KCS_3:
-		case HOST_KCS_4: {
-			uint8_t *kcs_buff;
-			kcs_buff = malloc(KCS_BUFF_SIZE * sizeof(uint8_t));
-			if (kcs_buff == NULL) { // allocate fail, retry allocate
-				k_msleep(10);
-				kcs_buff = malloc(KCS_BUFF_SIZE * sizeof(uint8_t));
-				if (kcs_buff == NULL) {
-					LOG_ERR("IPMI_handler: Fail to malloc for kcs_buff");
-					continue;
-				}
-			}
-			kcs_buff[0] = (msg_cfg.buffer.netfn + 1)
-				      << 2; // ipmi netfn response package
-			kcs_buff[1] = msg_cfg.buffer.cmd;
-			kcs_buff[2] = msg_cfg.buffer.completion_code;
-			if (msg_cfg.buffer.data_len) {
-				if (msg_cfg.buffer.data_len <= (KCS_BUFF_SIZE - 3))
-					memcpy(&kcs_buff[3], msg_cfg.buffer.data,
-					       msg_cfg.buffer.data_len);
-				else
-					memcpy(&kcs_buff[3], msg_cfg.buffer.data,
-					       (KCS_BUFF_SIZE - 3));
-			}
+	case HOST_KCS_1:
+	case HOST_KCS_2:
+	case HOST_KCS_3:
+	case HOST_KCS_4: {
+		uint8_t *kcs_buff = ipmi_msg_pool_alloc(K_MSEC(10));
+		if (kcs_buff == NULL) {
+			LOG_ERR("IPMI_handler: Fail to allocate kcs_buff");
+			return;
+		}
+		kcs_buff[0] = (msg_cfg->buffer.netfn + 1) << 2; // ipmi netfn response package
+		kcs_buff[1] = msg_cfg->buffer.cmd;
+		kcs_buff[2] = msg_cfg->buffer.completion_code;
+		if (msg_cfg->buffer.data_len) {
+			if (msg_cfg->buffer.data_len <= (KCS_BUFF_SIZE - 3))
+				memcpy(&kcs_buff[3], msg_cfg->buffer.data,
+				       msg_cfg->buffer.data_len);
+			else
+				memcpy(&kcs_buff[3], msg_cfg->buffer.data, (KCS_BUFF_SIZE - 3));
+		}
 
-			LOG_DBG("kcs from ipmi netfn %x, cmd %x, length %d, cc %x", kcs_buff[0],
-				kcs_buff[1], msg_cfg.buffer.data_len, kcs_buff[2]);
+		LOG_DBG("kcs from ipmi netfn %x, cmd %x, length %d, cc %x", kcs_buff[0],
+			kcs_buff[1], msg_cfg->buffer.data_len, kcs_buff[2]);
 
-			kcs_write(msg_cfg.buffer.InF_source - HOST_KCS_1, kcs_buff,
-				  msg_cfg.buffer.data_len + 3);
-			SAFE_FREE(kcs_buff);
-			break;
+		kcs_write(msg_cfg->buffer.InF_source - HOST_KCS_1, kcs_buff,
+			  msg_cfg->buffer.data_len + 3);
+		SAFE_IPMI_MSG_FREE(kcs_buff);
+		break;
+	}
+#endif
+	case PLDM:
+		/* the message should be passed to source by pldm format */
+		send_msg_by_pldm(msg_cfg);
+		break;
+	case SELF:
+		/* for bic self test */
+		if (k_msgq_put(&self_ipmi_msgq, msg_cfg, K_NO_WAIT)) {
+			k_msgq_purge(&self_ipmi_msgq);
+			LOG_ERR("Failed to put msg into self ipmi msgq");
+		}
+		break;
+	default: {
+#if MAX_IPMB_IDX
+		ipmb_error status;
+		status = ipmb_send_response(&msg_cfg->buffer,
+					    IPMB_inf_index_map[msg_cfg->buffer.InF_source]);
+		if (status != IPMB_ERROR_SUCCESS) {
+			LOG_ERR("IPMI_handler send IPMB resp fail status: %x", status);
 		}
 #endif
-		case PLDM:
-			/* the message should be passed to source by pldm format */
-			send_msg_by_pldm(&msg_cfg);
-			break;
-		case SELF:
-			/* for bic self test */
-			if (k_msgq_put(&self_ipmi_msgq, &msg_cfg, K_NO_WAIT)) {
-				k_msgq_purge(&self_ipmi_msgq);
-				LOG_ERR("Failed to put msg into self ipmi msgq");
-			}
-			break;
-		default: {
+		break;
+	}
+	}
+}
+
+static void ipmi_cmd_execute(ipmi_msg_cfg *msg_cfg)
+{
+	// Bus access done for the requester goes ahead of sensor polling
+	bool is_i2c_priority = (i2c_priority_enter() == 0);
+	if (!is_i2c_priority) {
+		LOG_WRN("No I2C priority for netfn 0x%x cmd 0x%x", msg_cfg->buffer.netfn,
+			msg_cfg->buffer.cmd);
+	}
+	uint32_t iana = ipmi_cmd_handle(msg_cfg);
+	if (is_i2c_priority) {
+		i2c_priority_exit();
+	}
+
+	ipmi_send_response(msg_cfg, iana);
+}
+
+#if IPMI_WORKER_NUM > 0
+static struct k_thread ipmi_worker[IPMI_WORKER_NUM];
+K_KERNEL_STACK_ARRAY_DEFINE(ipmi_worker_stack, IPMI_WORKER_NUM, IPMI_WORKER_STACK_SIZE);
+static char __aligned(4) ipmi_worker_msgq_buffer[IPMI_WORKER_NUM]
+						  [IPMI_WORKER_QUEUE_LEN * sizeof(ipmi_msg_cfg)];
+static struct k_msgq ipmi_worker_msgq[IPMI_WORKER_NUM];
+
+static void ipmi_worker_handler(void *arug0, void *arug1, void *arug2)
+{
+	struct k_msgq *msgq = (struct k_msgq *)arug0;
+	ipmi_msg_cfg msg_cfg;
+
+	while (1) {
+		k_msgq_get(msgq, &msg_cfg, K_FOREVER);
+		ipmi_cmd_execute(&msg_cfg);
+	}
+}
+#endif
+
+static uint8_t get_ipmi_source(uint8_t InF_source)
+{
+	switch (InF_source) {
+	case SELF:
+		return IPMI_SOURCE_SELF;
+	case BMC_USB:
+		return IPMI_SOURCE_USB;
+	case PLDM:
+		return IPMI_SOURCE_PLDM;
+	case HOST_KCS_1:
+	case HOST_KCS_2:
+	case HOST_KCS_3:
+	case HOST_KCS_4:
+		return IPMI_SOURCE_KCS + (InF_source - HOST_KCS_1);
+	default:
 #if MAX_IPMB_IDX
-			ipmb_error status;
-			status = ipmb_send_response(&msg_cfg.buffer,
-						    IPMB_inf_index_map[msg_cfg.buffer.InF_source]);
-			if (status != IPMB_ERROR_SUCCESS) {
-				LOG_ERR("IPMI_handler send IPMB resp fail status: %x", status);
-			}
+		if ((InF_source < RESERVED) && (IPMB_inf_index_map[InF_source] < MAX_IPMB_IDX)) {
+			return IPMI_SOURCE_IPMB + IPMB_inf_index_map[InF_source];
+		}
 #endif
-			break;
+		return IPMI_SOURCE_OTHER;
+	}
+}
+
+/* Put a request into ipmi_msgq. Each source channel could only have IPMI_SOURCE_QUEUE_LEN
+ * requests queued, so a burst from one channel never starves the others. A request which is not
+ * admitted is answered with CC_NODE_BUSY, msg_cfg is used to build that response.
+ */
+int ipmi_msgq_put(ipmi_msg_cfg *msg_cfg, k_timeout_t timeout)
+{
+	CHECK_NULL_ARG_WITH_RETURN(msg_cfg, -EINVAL);
+
+	uint8_t source = get_ipmi_source(msg_cfg->buffer.InF_source);
+
+	if (k_sem_take(&ipmi_source_sem[source], timeout) == 0) {
+		if (k_msgq_put(&ipmi_msgq, msg_cfg, K_NO_WAIT) == 0) {
+			atomic_inc(&ipmi_source_accepted[source]);
+			return 0;
 		}
+		k_sem_give(&ipmi_source_sem[source]);
+	}
+
+	LOG_WRN("IPMI msgq busy, source: 0x%x, netfn: 0x%x, cmd: 0x%x",
+		msg_cfg->buffer.InF_source, msg_cfg->buffer.netfn, msg_cfg->buffer.cmd);
+
+	if (pal_is_not_return_cmd(msg_cfg->buffer.netfn, msg_cfg->buffer.cmd)) {
+		atomic_inc(&ipmi_source_dropped[source]);
+		return -EBUSY;
+	}
+
+	atomic_inc(&ipmi_source_rejected[source]);
+	msg_cfg->buffer.completion_code = CC_NODE_BUSY;
+	msg_cfg->buffer.data_len = 0;
+	ipmi_send_response(msg_cfg, 0);
+	return -EBUSY;
+}
+
+static uint8_t get_ipmi_source_channel(uint8_t source)
+{
+	switch (source) {
+	case IPMI_SOURCE_SELF:
+		return SELF;
+	case IPMI_SOURCE_USB:
+		return BMC_USB;
+	case IPMI_SOURCE_PLDM:
+		return PLDM;
+	case IPMI_SOURCE_OTHER:
+		return RESERVED;
+	default:
+		break;
+	}
+
+	if (source < IPMI_SOURCE_IPMB) {
+		return HOST_KCS_1 + (source - IPMI_SOURCE_KCS);
+	}
+
+#if MAX_IPMB_IDX
+	for (uint8_t channel = 0; channel < RESERVED; channel++) {
+		if (IPMB_inf_index_map[channel] == source - IPMI_SOURCE_IPMB) {
+			return channel;
 		}
 	}
+#endif
+	return RESERVED;
+}
+
+bool get_ipmi_msgq_stat(uint8_t source, ipmi_msgq_stat *stat)
+{
+	CHECK_NULL_ARG_WITH_RETURN(stat, false);
+
+	if (source >= IPMI_SOURCE_MAX) {
+		return false;
+	}
+
+	stat->channel = get_ipmi_source_channel(source);
+	stat->queued = IPMI_SOURCE_QUEUE_LEN - k_sem_count_get(&ipmi_source_sem[source]);
+	stat->accepted = atomic_get(&ipmi_source_accepted[source]);
+	stat->rejected = atomic_get(&ipmi_source_rejected[source]);
+	stat->dropped = atomic_get(&ipmi_source_dropped[source]);
+	return true;
+}
+
+/* Fast commands run in IPMI_thread itself, device access and long running commands are handed
+ * to the worker of their class so they never hold up the commands behind them.
+ */
+void IPMI_handler(void *arug0, void *arug1, void *arug2)
+{
+	ipmi_msg_cfg msg_cfg;
+
+	while (1) {
+		memset(&msg_cfg, 0, sizeof(ipmi_msg_cfg));
+		k_msgq_get(&ipmi_msgq, &msg_cfg, K_FOREVER);
+		k_sem_give(&ipmi_source_sem[get_ipmi_source(msg_cfg.buffer.InF_source)]);
+
+#if IPMI_WORKER_NUM > 0
+		uint8_t cmd_class =
+			pal_get_ipmi_cmd_class(msg_cfg.buffer.netfn, msg_cfg.buffer.cmd);
+		if ((cmd_class != IPMI_CMD_CLASS_FAST) && (cmd_class <= IPMI_WORKER_NUM)) {
+			if (!k_msgq_put(&ipmi_worker_msgq[cmd_class - 1], &msg_cfg, K_NO_WAIT)) {
+				continue;
+			}
+
+			LOG_WRN("IPMI worker %d busy, netfn: %x, cmd: %x", cmd_class,
+				msg_cfg.buffer.netfn, msg_cfg.buffer.cmd);
+			msg_cfg.buffer.completion_code = CC_NODE_BUSY;
+			msg_cfg.buffer.data_len = 0;
+			ipmi_send_response(&msg_cfg, 0);
+			continue;
+		}
+#endif
+
+		ipmi_cmd_execute(&msg_cfg);
+	}
 }
 
 void ipmi_init(void)
 {
 	LOG_DBG("ipmi_init");
+	ipmi_cmd_table_init();
 	k_msgq_init(&ipmi_msgq, ipmi_msgq_buffer, sizeof(struct ipmi_msg_cfg), IPMI_BUF_LEN);
 	k_msgq_init(&self_ipmi_msgq, self_ipmi_msgq_buffer, sizeof(struct ipmi_msg_cfg), 1);
+	for (uint8_t i = 0; i < IPMI_SOURCE_MAX; i++) {
+		k_sem_init(&ipmi_source_sem[i], IPMI_SOURCE_QUEUE_LEN, IPMI_SOURCE_QUEUE_LEN);
+	}
 
 	k_thread_create(&IPMI_thread, IPMI_thread_stack, K_THREAD_STACK_SIZEOF(IPMI_thread_stack),
 			IPMI_handler, NULL, NULL, NULL, CONFIG_MAIN_THREAD_PRIORITY, 0, K_NO_WAIT);
 	k_thread_name_set(&IPMI_thread, "IPMI_thread");
 
+#if IPMI_WORKER_NUM > 0
+	for (uint8_t i = 0; i < IPMI_WORKER_NUM; i++) {
+		k_msgq_init(&ipmi_worker_msgq[i], ipmi_worker_msgq_buffer[i], sizeof(ipmi_msg_cfg),
+			    IPMI_WORKER_QUEUE_LEN);
+		// each class runs at a lower priority than IPMI_thread and the classes before it
+		k_thread_create(&ipmi_worker[i], ipmi_worker_stack[i],
+				K_THREAD_STACK_SIZEOF(ipmi_worker_stack[i]), ipmi_worker_handler,
+				&ipmi_worker_msgq[i], NULL, NULL,
+				CONFIG_MAIN_THREAD_PRIORITY + i + 1, 0, K_NO_WAIT);
+		k_thread_name_set(&ipmi_worker[i], (i == 0) ? "IPMI_device_worker" :
+							      "IPMI_long_worker");
+	}
+#endif
+
 #if MAX_IPMB_IDX
 	ipmb_init();
 #endif
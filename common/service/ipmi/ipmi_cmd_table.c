@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ipmi_cmd_table.h"
+
+#include <zephyr.h>
+#include <string.h>
+#include <logging/log.h>
+#include "app_handler.h"
+#include "chassis_handler.h"
+#include "oem_handler.h"
+#include "oem_1s_handler.h"
+#include "sensor_handler.h"
+#include "storage_handler.h"
+#include "libutil.h"
+
+LOG_MODULE_REGISTER(ipmi_cmd_table);
+
+#ifndef IPMI_CMD_TABLE_SIZE
+#define IPMI_CMD_TABLE_SIZE IPMI_CMD_TABLE_SIZE_DEFAULT
+#endif
+
+BUILD_ASSERT((IPMI_CMD_TABLE_SIZE & (IPMI_CMD_TABLE_SIZE - 1)) == 0,
+	     "IPMI_CMD_TABLE_SIZE must be a power of 2");
+
+#define IPMI_CMD_SLOT_NULL 0xFFFF
+
+typedef struct _ipmi_cmd_slot {
+	const ipmi_cmd_entry *entry;
+	ipmi_cmd_stat stat;
+} ipmi_cmd_slot;
+
+/* Open addressing hash table keyed by netfn/cmd, only written while registering */
+static ipmi_cmd_slot cmd_slot[IPMI_CMD_TABLE_SIZE];
+/* Slot of each registered command in registration order, used to list statistics */
+static uint16_t cmd_order[IPMI_CMD_TABLE_SIZE];
+static uint16_t cmd_count;
+K_MUTEX_DEFINE(ipmi_cmd_stat_mutex);
+
+/* Platforms register their own commands or replace common ones here */
+__weak void pal_register_ipmi_cmd(void)
+{
+	return;
+}
+
+/* Highest IPMI_CMD_PRIVILEGE granted to requests from a channel. The BIC has no IPMI sessions,
+ * so every channel is trusted by default, platforms could restrict e.g. expansion boards.
+ */
+__weak uint8_t pal_get_ipmi_source_privilege(uint8_t InF_source)
+{
+	return IPMI_CMD_PRIV_ADMIN;
+}
+
+static uint16_t get_hash(uint8_t netfn, uint8_t cmd)
+{
+	return ((netfn * 37) + cmd) & (IPMI_CMD_TABLE_SIZE - 1);
+}
+
+/* Return the slot of netfn/cmd, or the free slot to put it in */
+static ipmi_cmd_slot *find_slot(uint8_t netfn, uint8_t cmd)
+{
+	uint16_t index = get_hash(netfn, cmd);
+
+	for (uint16_t i = 0; i < IPMI_CMD_TABLE_SIZE; i++) {
+		ipmi_cmd_slot *slot = &cmd_slot[index];
+		if ((slot->entry == NULL) ||
+		    ((slot->stat.netfn == netfn) && (slot->stat.cmd == cmd))) {
+			return slot;
+		}
+		index = (index + 1) & (IPMI_CMD_TABLE_SIZE - 1);
+	}
+	return NULL;
+}
+
+static ipmi_cmd_slot *get_slot(uint8_t netfn, uint8_t cmd)
+{
+	ipmi_cmd_slot *slot = find_slot(netfn, cmd);
+	if ((slot == NULL) || (slot->entry == NULL)) {
+		return NULL;
+	}
+	return slot;
+}
+
+/* Register commands of a netfn, an entry of a registered netfn/cmd replaces the old one */
+bool ipmi_cmd_register_table(uint8_t netfn, const ipmi_cmd_entry *table, uint8_t count)
+{
+	CHECK_NULL_ARG_WITH_RETURN(table, false);
+
+	for (uint8_t i = 0; i < count; i++) {
+		ipmi_cmd_slot *slot = find_slot(netfn, table[i].cmd);
+		if (slot == NULL) {
+			LOG_ERR("IPMI command table full, netfn 0x%x cmd 0x%x", netfn,
+				table[i].cmd);
+			return false;
+		}
+
+		if (slot->entry == NULL) {
+			slot->stat.netfn = netfn;
+			slot->stat.cmd = table[i].cmd;
+			cmd_order[cmd_count++] = slot - cmd_slot;
+		}
+		slot->entry = &table[i];
+	}
+	return true;
+}
+
+void ipmi_cmd_table_init(void)
+{
+	memset(cmd_slot, 0, sizeof(cmd_slot));
+	cmd_count = 0;
+
+	chassis_cmd_register();
+	sensor_cmd_register();
+	app_cmd_register();
+	storage_cmd_register();
+	oem_cmd_register();
+	oem_1s_cmd_register();
+	pal_register_ipmi_cmd();
+
+	LOG_INF("%d IPMI commands registered", cmd_count);
+}
+
+static void record_stat(ipmi_cmd_stat *stat, uint32_t elapsed_us, bool is_error)
+{
+	k_mutex_lock(&ipmi_cmd_stat_mutex, K_FOREVER);
+	if ((stat->count == 0) || (elapsed_us < stat->min_us)) {
+		stat->min_us = elapsed_us;
+	}
+	if (elapsed_us > stat->max_us) {
+		stat->max_us = elapsed_us;
+	}
+	stat->total_us += elapsed_us;
+	stat->count++;
+	if (is_error) {
+		stat->error++;
+	}
+	k_mutex_unlock(&ipmi_cmd_stat_mutex);
+}
+
+void ipmi_cmd_dispatch(ipmi_msg *msg)
+{
+	CHECK_NULL_ARG(msg);
+
+	ipmi_cmd_slot *slot = get_slot(msg->netfn, msg->cmd);
+	if (slot == NULL) {
+		LOG_ERR("Invalid msg netfn: %x, cmd: %x", msg->netfn, msg->cmd);
+		msg->data_len = 0;
+		msg->completion_code = CC_INVALID_CMD;
+		return;
+	}
+
+	const ipmi_cmd_entry *entry = slot->entry;
+	if (msg->data_len < entry->min_data_len) {
+		msg->data_len = 0;
+		msg->completion_code = CC_INVALID_LENGTH;
+		record_stat(&slot->stat, 0, true);
+		return;
+	}
+
+	if (entry->privilege > pal_get_ipmi_source_privilege(msg->InF_source)) {
+		LOG_WRN("Insufficient privilege, source 0x%x netfn 0x%x cmd 0x%x", msg->InF_source,
+			msg->netfn, msg->cmd);
+		msg->data_len = 0;
+		msg->completion_code = CC_INSUFFICIENT_PRIVILEGE;
+		record_stat(&slot->stat, 0, true);
+		return;
+	}
+
+	if (entry->handler == NULL) {
+		msg->data_len = 0;
+		msg->completion_code = CC_SUCCESS;
+		record_stat(&slot->stat, 0, false);
+		return;
+	}
+
+	/* 32-bit cycle count wraps in seconds, slow commands could take longer */
+	int64_t start = k_uptime_ticks();
+	entry->handler(msg);
+	uint32_t elapsed_us = (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks() - start);
+
+	record_stat(&slot->stat, elapsed_us, (msg->completion_code != CC_SUCCESS));
+}
+
+uint8_t ipmi_cmd_get_class(uint8_t netfn, uint8_t cmd)
+{
+	const ipmi_cmd_slot *slot = get_slot(netfn, cmd);
+	return (slot == NULL) ? IPMI_CMD_CLASS_FAST : slot->entry->cmd_class;
+}
+
+uint16_t get_ipmi_cmd_count(void)
+{
+	return cmd_count;
+}
+
+/* Get statistics of the index-th registered command */
+bool get_ipmi_cmd_stat(uint16_t index, ipmi_cmd_stat *stat)
+{
+	CHECK_NULL_ARG_WITH_RETURN(stat, false);
+
+	if (index >= cmd_count) {
+		return false;
+	}
+
+	k_mutex_lock(&ipmi_cmd_stat_mutex, K_FOREVER);
+	*stat = cmd_slot[cmd_order[index]].stat;
+	k_mutex_unlock(&ipmi_cmd_stat_mutex);
+	return true;
+}
+
+void clear_ipmi_cmd_stat(void)
+{
+	k_mutex_lock(&ipmi_cmd_stat_mutex, K_FOREVER);
+	for (uint16_t i = 0; i < cmd_count; i++) {
+		ipmi_cmd_stat *stat = &cmd_slot[cmd_order[i]].stat;
+		uint8_t netfn = stat->netfn;
+		uint8_t cmd = stat->cmd;
+		memset(stat, 0, sizeof(*stat));
+		stat->netfn = netfn;
+		stat->cmd = cmd;
+	}
+	k_mutex_unlock(&ipmi_cmd_stat_mutex);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ipmi_msg_pool.h"
+
+#include <logging/log.h>
+#include "libutil.h"
+
+LOG_MODULE_REGISTER(ipmi_msg_pool);
+
+#ifndef IPMI_MSG_POOL_NUM
+#define IPMI_MSG_POOL_NUM IPMI_MSG_POOL_NUM_DEFAULT
+#endif
+
+typedef struct _ipmi_msg_pool_block {
+	atomic_t in_use;
+	uint8_t buf[IPMI_MSG_POOL_BUF_SIZE] __aligned(4);
+} ipmi_msg_pool_block;
+
+K_MEM_SLAB_DEFINE(ipmi_msg_slab, sizeof(ipmi_msg_pool_block), IPMI_MSG_POOL_NUM, 4);
+
+static atomic_t pool_max_used;
+static atomic_t pool_alloc_fail;
+
+/* Get a buffer of IPMI_MSG_POOL_BUF_SIZE bytes, content is not cleared */
+void *ipmi_msg_pool_alloc(k_timeout_t timeout)
+{
+	ipmi_msg_pool_block *block;
+
+	if (k_mem_slab_alloc(&ipmi_msg_slab, (void **)&block, timeout) != 0) {
+		atomic_inc(&pool_alloc_fail);
+		LOG_WRN("IPMI message pool exhausted");
+		return NULL;
+	}
+
+	atomic_set(&block->in_use, 1);
+
+	atomic_val_t used = k_mem_slab_num_used_get(&ipmi_msg_slab);
+	atomic_val_t max_used;
+	do {
+		max_used = atomic_get(&pool_max_used);
+	} while ((used > max_used) && !atomic_cas(&pool_max_used, max_used, used));
+
+	return block->buf;
+}
+
+void ipmi_msg_pool_free(void *buf)
+{
+	CHECK_NULL_ARG(buf);
+
+	ipmi_msg_pool_block *block = CONTAINER_OF(buf, ipmi_msg_pool_block, buf);
+	if (!atomic_cas(&block->in_use, 1, 0)) {
+		LOG_ERR("Free IPMI message buffer %p twice", buf);
+		return;
+	}
+
+	k_mem_slab_free(&ipmi_msg_slab, (void **)&block);
+}
+
+void get_ipmi_msg_pool_stat(ipmi_msg_pool_stat *stat)
+{
+	CHECK_NULL_ARG(stat);
+
+	stat->total = IPMI_MSG_POOL_NUM;
+	stat->used = k_mem_slab_num_used_get(&ipmi_msg_slab);
+	stat->max_used = atomic_get(&pool_max_used);
+	stat->alloc_fail = atomic_get(&pool_alloc_fail);
+}
@@ -15,11 +15,14 @@
  */
 
 #include "oem_1s_handler.h"
+#include "ipmi_cmd_table.h"
 #include <stdlib.h>
 #include <drivers/peci.h>
 #include "libutil.h"
 #include "ipmb.h"
+#include "ipmi_msg_pool.h"
 #include "sensor.h"
+#include "sensor_history.h"
 #include "snoop.h"
 #include "pmic.h"
 #include "hal_gpio.h"
@@ -49,9 +52,6 @@
 #include "pcc.h"
 #include "hal_wdt.h"
 
-#define BIOS_UPDATE_MAX_OFFSET 0x4000000
-#define BIC_UPDATE_MAX_OFFSET 0x50000
-
 #define _4BYTE_ACCURACY_SENSOR_READING_RES_LEN 5
 #define MAX_MULTI_ACCURACY_SENSOR_READING_QUERY_NUM 32
 #define MAX_CONTROL_SENSOR_POLLING_COUNT 10
@@ -115,7 +115,7 @@ __weak void OEM_1S_MSG_OUT(ipmi_msg *msg)
 
 	// only send to target while msg is valid
 	if (msg->completion_code == CC_SUCCESS) {
-		bridge_msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+		bridge_msg = (ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 		if (bridge_msg == NULL) {
 			msg->completion_code = CC_OUT_OF_SPACE;
 		} else {
@@ -143,7 +143,7 @@ __weak void OEM_1S_MSG_OUT(ipmi_msg *msg)
 				LOG_ERR("OEM_MSG_OUT send IPMB req fail status: %x", status);
 				msg->completion_code = CC_BRIDGE_MSG_ERR;
 			}
-			SAFE_FREE(bridge_msg);
+			SAFE_IPMI_MSG_FREE(bridge_msg);
 		}
 	}
 
@@ -427,7 +427,7 @@ __weak void OEM_1S_GET_FW_VERSION(ipmi_msg *msg)
 			return;
 		}
 
-		bridge_msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+		bridge_msg = (ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 		if (bridge_msg == NULL) {
 			msg->completion_code = CC_OUT_OF_SPACE;
 			return;
@@ -442,7 +442,7 @@ __weak void OEM_1S_GET_FW_VERSION(ipmi_msg *msg)
 		status = ipmb_read(bridge_msg, IPMB_inf_index_map[bridge_msg->InF_target]);
 		if (status != IPMB_ERROR_SUCCESS) {
 			LOG_ERR("ipmb read fail status: %x", status);
-			SAFE_FREE(bridge_msg);
+			SAFE_IPMI_MSG_FREE(bridge_msg);
 			msg->completion_code = CC_BRIDGE_MSG_ERR;
 			return;
 		} else {
@@ -453,7 +453,7 @@ __weak void OEM_1S_GET_FW_VERSION(ipmi_msg *msg)
 			msg->data[4] = bridge_msg->data[13] >> 4;
 			msg->data_len = 5;
 			msg->completion_code = CC_SUCCESS;
-			SAFE_FREE(bridge_msg);
+			SAFE_IPMI_MSG_FREE(bridge_msg);
 		}
 		break;
 #endif
@@ -914,7 +914,7 @@ __weak void OEM_1S_ACCURACY_SENSOR_READING(ipmi_msg *msg)
 	ACCURACY_SENSOR_READING_RES *res = (ACCURACY_SENSOR_READING_RES *)msg->data;
 	uint8_t status = -1, sensor_report_status;
 	int reading;
-	if (msg->data_len != 2) {
+	if ((msg->data_len != 2) && (msg->data_len != sizeof(ACCURACY_SENSOR_READING_REQ))) {
 		msg->completion_code = CC_INVALID_LENGTH;
 		return;
 	}
@@ -927,10 +927,13 @@ __weak void OEM_1S_ACCURACY_SENSOR_READING(ipmi_msg *msg)
 	}
 
 	if (req->read_option == GET_FROM_CACHE) {
-		if (enable_sensor_poll_thread) {
-			status = get_sensor_reading(req->sensor_num, &reading, GET_FROM_CACHE);
-		} else {
+		if (!enable_sensor_poll_thread) {
 			status = SENSOR_POLLING_DISABLE;
+		} else if (msg->data_len == sizeof(ACCURACY_SENSOR_READING_REQ)) {
+			status = get_sensor_reading_max_age(req->sensor_num, &reading,
+							    req->max_age_ms);
+		} else {
+			status = get_sensor_reading(req->sensor_num, &reading, GET_FROM_CACHE);
 		}
 	} else if (req->read_option == GET_FROM_SENSOR) {
 		status = get_sensor_reading(req->sensor_num, &reading, GET_FROM_SENSOR);
@@ -1732,6 +1735,124 @@ __weak void OEM_1S_MULTI_ACCURACY_SENSOR_READING(ipmi_msg *msg)
 	msg->completion_code = CC_SUCCESS;
 }
 
+static uint8_t pack_sensor_history_value(uint8_t *buf, int32_t value)
+{
+	sensor_val sval;
+	sval.integer = value / 1000;
+	sval.fraction = value % 1000;
+	memcpy(buf, &sval, sizeof(sval));
+	return sizeof(sval);
+}
+
+__weak void OEM_1S_GET_SENSOR_HISTORY(ipmi_msg *msg)
+{
+	/*********************************
+	Request -
+	data 0: sensor number
+	data 1 ~ 4: window in ms, LSB first, 0 means all samples
+	data 5: number of raw samples to return
+	Response -
+	data 0 ~ 1: number of samples in the window, LSB first
+	data 2 ~ 13: min, max, average in 4-byte accuracy reading format
+	data 14 ~ N: raw samples in 4-byte accuracy reading format, newest first
+	***********************************/
+	CHECK_NULL_ARG(msg);
+
+	if (msg->data_len != 6) {
+		msg->completion_code = CC_INVALID_LENGTH;
+		return;
+	}
+
+	uint8_t sensor_num = msg->data[0];
+	uint32_t window_ms = msg->data[1] | (msg->data[2] << 8) | (msg->data[3] << 16) |
+			     ((uint32_t)msg->data[4] << 24);
+	uint8_t sample_count = msg->data[5];
+
+	if (sample_count > SENSOR_HISTORY_QUERY_SAMPLE_MAX) {
+		msg->completion_code = CC_PARAM_OUT_OF_RANGE;
+		return;
+	}
+
+	sensor_history_stat stat;
+	if (!sensor_history_get_stat(sensor_num, window_ms, &stat)) {
+		msg->completion_code = CC_INVALID_DATA_FIELD;
+		return;
+	}
+
+	sensor_history_sample samples[SENSOR_HISTORY_QUERY_SAMPLE_MAX];
+	sample_count = sensor_history_get_samples(sensor_num, window_ms, samples, sample_count);
+
+	uint16_t ofs = 0;
+	msg->data[ofs++] = stat.count & 0xFF;
+	msg->data[ofs++] = (stat.count >> 8) & 0xFF;
+	ofs += pack_sensor_history_value(&msg->data[ofs], stat.min);
+	ofs += pack_sensor_history_value(&msg->data[ofs], stat.max);
+	ofs += pack_sensor_history_value(&msg->data[ofs], stat.avg);
+	for (uint8_t i = 0; i < sample_count; i++) {
+		ofs += pack_sensor_history_value(&msg->data[ofs], samples[i].value);
+	}
+
+	msg->data_len = ofs;
+	msg->completion_code = CC_SUCCESS;
+}
+
+BUILD_ASSERT((IPMB_RESP_HEADER_LENGTH + 3 + 3 +
+	      (IPMI_CMD_STAT_QUERY_MAX * IPMI_CMD_STAT_QUERY_ENTRY_SIZE)) <= UINT8_MAX,
+	     "IPMI command statistics response exceeds an IPMB frame");
+
+__weak void OEM_1S_GET_IPMI_CMD_STAT(ipmi_msg *msg)
+{
+	/*********************************
+	Request -
+	data 0: index of the first registered command to return
+	data 1: 1 to clear all statistics after reading, otherwise 0
+	Response -
+	data 0 ~ 1: number of registered commands, LSB first
+	data 2: number of commands returned
+	data 3 ~ N: per command, LSB first
+		netfn, cmd, invocations (4 bytes), errors (4 bytes),
+		min, average, max execution time in us (4 bytes each)
+	***********************************/
+	CHECK_NULL_ARG(msg);
+
+	if (msg->data_len != 2) {
+		msg->completion_code = CC_INVALID_LENGTH;
+		return;
+	}
+
+	uint8_t start = msg->data[0];
+	bool is_clear = (msg->data[1] == 1);
+	uint16_t total = get_ipmi_cmd_count();
+	uint16_t ofs = 3;
+	uint8_t count = 0;
+	ipmi_cmd_stat stat;
+
+	for (; count < IPMI_CMD_STAT_QUERY_MAX; count++) {
+		if (!get_ipmi_cmd_stat(start + count, &stat)) {
+			break;
+		}
+
+		uint32_t avg_us = stat.count ? (uint32_t)(stat.total_us / stat.count) : 0;
+		uint32_t value[] = { stat.count, stat.error, stat.min_us, avg_us, stat.max_us };
+		msg->data[ofs++] = stat.netfn;
+		msg->data[ofs++] = stat.cmd;
+		for (uint8_t i = 0; i < ARRAY_SIZE(value); i++) {
+			memcpy(&msg->data[ofs], &value[i], sizeof(uint32_t));
+			ofs += sizeof(uint32_t);
+		}
+	}
+
+	if (is_clear) {
+		clear_ipmi_cmd_stat();
+	}
+
+	msg->data[0] = total & 0xFF;
+	msg->data[1] = (total >> 8) & 0xFF;
+	msg->data[2] = count;
+	msg->data_len = ofs;
+	msg->completion_code = CC_SUCCESS;
+}
+
 __weak void OEM_1S_CLEAR_CMOS(ipmi_msg *msg)
 {
 	CHECK_NULL_ARG(msg);
@@ -2105,271 +2226,101 @@ __weak void OEM_1S_GET_DIMM_I3C_MUX_SELECTION(ipmi_msg *msg)
 	return;
 }
 
-void IPMI_OEM_1S_handler(ipmi_msg *msg)
-{
-	CHECK_NULL_ARG(msg);
-	switch (msg->cmd) {
-	case CMD_OEM_1S_MSG_IN:
-		LOG_DBG("Received 1S Message In command");
-		break;
-	case CMD_OEM_1S_MSG_OUT:
-		LOG_DBG("Received 1S Message Out command");
-		OEM_1S_MSG_OUT(msg);
-		break;
-	case CMD_OEM_1S_GET_GPIO:
-		LOG_DBG("Received 1S Get GPIO command");
-		OEM_1S_GET_GPIO(msg);
-		break;
-	case CMD_OEM_1S_SET_GPIO:
-		LOG_DBG("Received 1S Set GPIO command");
-		break;
-	case CMD_OEM_1S_GET_GPIO_CONFIG:
-		LOG_DBG("Received 1S Get GPIO Config command");
-		OEM_1S_GET_GPIO_CONFIG(msg);
-		break;
-	case CMD_OEM_1S_SET_GPIO_CONFIG:
-		LOG_DBG("Received 1S Get GPIO Config command");
-		OEM_1S_SET_GPIO_CONFIG(msg);
-		break;
-	case CMD_OEM_1S_FW_UPDATE:
-		LOG_DBG("Received 1S Firmware Update command");
-		OEM_1S_FW_UPDATE(msg);
-		break;
-	case CMD_OEM_1S_GET_BIC_FW_INFO:
-		LOG_DBG("Received 1S Get BIC fw info command");
-		OEM_1S_GET_BIC_FW_INFO(msg);
-		break;
-	case CMD_OEM_1S_GET_FW_VERSION:
-		LOG_DBG("Received 1S Get Firmware Version command");
-		OEM_1S_GET_FW_VERSION(msg);
-		break;
-	case CMD_OEM_1S_RESET_BMC:
-		LOG_DBG("Received 1S BMC Reset command");
-		OEM_1S_RESET_BMC(msg);
-		break;
-	case CMD_OEM_1S_READ_FW_IMAGE:
-		LOG_DBG("Received 1S read fw image command");
-		OEM_1S_READ_FW_IMAGE(msg);
-		break;
-	case CMD_OEM_1S_SET_WDT_FEED:
-		LOG_DBG("Received 1S Set WatchDogTimer Feed command");
-		OEM_1S_SET_WDT_FEED(msg);
-		break;
-	case CMD_OEM_1S_SENSOR_POLL_EN: // debug command
-		LOG_DBG("Received 1S Sensor Poll Enable (Debug) command");
-		OEM_1S_SENSOR_POLL_EN(msg);
-		break;
-	case CMD_OEM_1S_ACCURACY_SENSOR_READING:
-		LOG_DBG("Received 1S Sesnor Reading (Accuracy) command");
-		OEM_1S_ACCURACY_SENSOR_READING(msg);
-		break;
-	case CMD_OEM_1S_GET_SET_GPIO:
-		LOG_DBG("Received 1S Get/Set GPIO command");
-		OEM_1S_GET_SET_GPIO(msg);
-		break;
-	case CMD_OEM_1S_GET_SET_BIC_VGPIO:
-		LOG_DBG("Received 1S Get/Set BIC vGPIO command");
-		OEM_1S_GET_SET_BIC_VGPIO(msg);
-		break;
-	case CMD_OEM_1S_CONTROL_SENSOR_POLLING:
-		LOG_DBG("Received 1S Sensor Polling Control command");
-		OEM_1S_CONTROL_SENSOR_POLLING(msg);
-		break;
+static const ipmi_cmd_entry oem_1s_cmd_table[] = {
+	{ CMD_OEM_1S_MSG_IN, NULL },
+	{ CMD_OEM_1S_MSG_OUT, OEM_1S_MSG_OUT, IPMI_CMD_CLASS_FAST, 3 },
+	{ CMD_OEM_1S_GET_GPIO, OEM_1S_GET_GPIO },
+	{ CMD_OEM_1S_SET_GPIO, NULL },
+	{ CMD_OEM_1S_GET_GPIO_CONFIG, OEM_1S_GET_GPIO_CONFIG },
+	{ CMD_OEM_1S_SET_GPIO_CONFIG, OEM_1S_SET_GPIO_CONFIG },
+	{ CMD_OEM_1S_FW_UPDATE, OEM_1S_FW_UPDATE, IPMI_CMD_CLASS_LONG, 8, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_OEM_1S_GET_BIC_FW_INFO, OEM_1S_GET_BIC_FW_INFO, IPMI_CMD_CLASS_FAST, 1 },
+	{ CMD_OEM_1S_GET_FW_VERSION, OEM_1S_GET_FW_VERSION, IPMI_CMD_CLASS_DEVICE, 1 },
+	{ CMD_OEM_1S_RESET_BMC, OEM_1S_RESET_BMC, IPMI_CMD_CLASS_FAST, 0, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_OEM_1S_READ_FW_IMAGE, OEM_1S_READ_FW_IMAGE, IPMI_CMD_CLASS_LONG, 6 },
+	{ CMD_OEM_1S_SET_WDT_FEED, OEM_1S_SET_WDT_FEED, IPMI_CMD_CLASS_FAST, 1 },
+	{ CMD_OEM_1S_SENSOR_POLL_EN, OEM_1S_SENSOR_POLL_EN, IPMI_CMD_CLASS_FAST, 1 },
+	{ CMD_OEM_1S_ACCURACY_SENSOR_READING, OEM_1S_ACCURACY_SENSOR_READING,
+	  IPMI_CMD_CLASS_DEVICE, 2 },
+	{ CMD_OEM_1S_GET_SET_GPIO, OEM_1S_GET_SET_GPIO, IPMI_CMD_CLASS_FAST, 2 },
+	{ CMD_OEM_1S_GET_SET_BIC_VGPIO, OEM_1S_GET_SET_BIC_VGPIO, IPMI_CMD_CLASS_FAST, 2 },
+	{ CMD_OEM_1S_CONTROL_SENSOR_POLLING, OEM_1S_CONTROL_SENSOR_POLLING },
 #ifdef CONFIG_CRYPTO_ASPEED
-	case CMD_OEM_1S_GET_FW_SHA256:
-		LOG_DBG("Received 1S Get Firmware SHA256 command");
-		OEM_1S_GET_FW_SHA256(msg);
-		break;
+	{ CMD_OEM_1S_GET_FW_SHA256, OEM_1S_GET_FW_SHA256, IPMI_CMD_CLASS_LONG, 9 },
 #endif
-	case CMD_OEM_1S_I2C_DEV_SCAN: // debug command
-		LOG_DBG("Received 1S I2C Device Scan (Debug) command");
-		OEM_1S_I2C_DEV_SCAN(msg);
-		break;
-	case CMD_OEM_1S_GET_BIC_STATUS:
-		LOG_DBG("Received 1S Get BIC Status command");
-		OEM_1S_GET_BIC_STATUS(msg);
-		break;
-	case CMD_OEM_1S_SET_VR_MONITOR_STATUS:
-		LOG_DBG("Received 1S Set VR Monitor Status command");
-		OEM_1S_SET_VR_MONITOR_STATUS(msg);
-		break;
-	case CMD_OEM_1S_GET_VR_MONITOR_STATUS:
-		LOG_DBG("Received 1S Get VR Monitor Status command");
-		OEM_1S_GET_VR_MONITOR_STATUS(msg);
-		break;
-	case CMD_OEM_1S_RESET_BIC:
-		LOG_DBG("Received 1S Reset BIC command");
-		OEM_1S_RESET_BIC(msg);
-		break;
-	case CMD_OEM_1S_GET_SET_M2:
-		LOG_DBG("Received 1S Get/Set M2 command");
-		OEM_1S_GET_SET_M2(msg);
-		break;
-	case CMD_OEM_1S_SET_SSD_LED:
-		LOG_DBG("Received 1S Set SSD LED command");
-		OEM_1S_SET_SSD_LED(msg);
-		break;
-	case CMD_OEM_1S_GET_SSD_STATUS:
-		LOG_DBG("Received 1S Get SSD Status command");
-		OEM_1S_GET_SSD_STATUS(msg);
-		break;
-	case CMD_OEM_1S_12V_CYCLE_SLOT:
-		LOG_DBG("Received 1S 12v-Cycle Slot command");
-		OEM_1S_12V_CYCLE_SLOT(msg);
-		break;
-	case CMD_OEM_1S_READ_BIC_REGISTER:
-		LOG_DBG("Received 1S Read BIC Register command");
-		OEM_1S_READ_BIC_REGISTER(msg);
-		break;
-	case CMD_OEM_1S_WRITE_BIC_REGISTER:
-		LOG_DBG("Received 1S Write BIC Register command");
-		OEM_1S_WRITE_BIC_REGISTER(msg);
-		break;
-	case CMD_OEM_1S_CLEAR_CMOS:
-		LOG_DBG("Received 1S Clear CMOS command");
-		OEM_1S_CLEAR_CMOS(msg);
-		break;
+	{ CMD_OEM_1S_I2C_DEV_SCAN, OEM_1S_I2C_DEV_SCAN, IPMI_CMD_CLASS_DEVICE, 1 },
+	{ CMD_OEM_1S_GET_BIC_STATUS, OEM_1S_GET_BIC_STATUS },
+	{ CMD_OEM_1S_SET_VR_MONITOR_STATUS, OEM_1S_SET_VR_MONITOR_STATUS, IPMI_CMD_CLASS_FAST, 1 },
+	{ CMD_OEM_1S_GET_VR_MONITOR_STATUS, OEM_1S_GET_VR_MONITOR_STATUS },
+	{ CMD_OEM_1S_RESET_BIC, OEM_1S_RESET_BIC, IPMI_CMD_CLASS_FAST, 0, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_OEM_1S_GET_SET_M2, OEM_1S_GET_SET_M2 },
+	{ CMD_OEM_1S_SET_SSD_LED, OEM_1S_SET_SSD_LED },
+	{ CMD_OEM_1S_GET_SSD_STATUS, OEM_1S_GET_SSD_STATUS },
+	{ CMD_OEM_1S_12V_CYCLE_SLOT, OEM_1S_12V_CYCLE_SLOT,
+	  IPMI_CMD_CLASS_FAST, 0, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_OEM_1S_READ_BIC_REGISTER, OEM_1S_READ_BIC_REGISTER, IPMI_CMD_CLASS_FAST, 5 },
+	{ CMD_OEM_1S_WRITE_BIC_REGISTER, OEM_1S_WRITE_BIC_REGISTER,
+	  IPMI_CMD_CLASS_FAST, 0, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_OEM_1S_CLEAR_CMOS, OEM_1S_CLEAR_CMOS, IPMI_CMD_CLASS_FAST, 0, IPMI_CMD_PRIV_ADMIN },
 #ifdef CONFIG_SNOOP_ASPEED
-	case CMD_OEM_1S_GET_POST_CODE:
-		LOG_DBG("Received 1S Get Post Code command");
-		OEM_1S_GET_POST_CODE(msg);
-		break;
+	{ CMD_OEM_1S_GET_POST_CODE, OEM_1S_GET_POST_CODE },
 #endif
 #ifdef CONFIG_PCC_ASPEED
-	case CMD_OEM_1S_GET_4BYTE_POST_CODE:
-		LOG_DBG("Received 1S Get Post Code (4-Byte) command");
-		OEM_1S_GET_4BYTE_POST_CODE(msg);
-		break;
+	{ CMD_OEM_1S_GET_4BYTE_POST_CODE, OEM_1S_GET_4BYTE_POST_CODE, IPMI_CMD_CLASS_FAST, 1 },
 #endif
 #ifdef CONFIG_PECI
-	case CMD_OEM_1S_PECI_ACCESS:
-		LOG_DBG("Received 1S Access PECI command");
-		OEM_1S_PECI_ACCESS(msg);
-		break;
+	{ CMD_OEM_1S_PECI_ACCESS, OEM_1S_PECI_ACCESS,
+	  IPMI_CMD_CLASS_DEVICE, 3, IPMI_CMD_PRIV_ADMIN },
 #endif
 #ifdef ENABLE_APML
-	case CMD_OEM_1S_APML_READ:
-		LOG_DBG("Received 1S APML Read command");
-		OEM_1S_APML_READ(msg);
-		break;
-	case CMD_OEM_1S_APML_WRITE:
-		LOG_DBG("Received 1S APML Write command");
-		OEM_1S_APML_WRITE(msg);
-		break;
-	case CMD_OEM_1S_SEND_APML_REQUEST:
-		LOG_DBG("Received 1S Send APML Request command");
-		OEM_1S_SEND_APML_REQUEST(msg);
-		break;
-	case CMD_OEM_1S_GET_APML_RESPONSE:
-		LOG_DBG("Received 1S Get APML Response command");
-		OEM_1S_GET_APML_RESPONSE(msg);
-		break;
+	{ CMD_OEM_1S_APML_READ, OEM_1S_APML_READ, IPMI_CMD_CLASS_DEVICE, 2 },
+	{ CMD_OEM_1S_APML_WRITE, OEM_1S_APML_WRITE, IPMI_CMD_CLASS_DEVICE, 3, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_OEM_1S_SEND_APML_REQUEST, OEM_1S_SEND_APML_REQUEST,
+	  IPMI_CMD_CLASS_DEVICE, 1, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_OEM_1S_GET_APML_RESPONSE, OEM_1S_GET_APML_RESPONSE, IPMI_CMD_CLASS_FAST, 1 },
 #endif
 #ifdef CONFIG_JTAG
-	case CMD_OEM_1S_SET_JTAG_TAP_STA:
-		LOG_DBG("Received 1S Set JTAG Tap Status command");
-		OEM_1S_SET_JTAG_TAP_STA(msg);
-		break;
-	case CMD_OEM_1S_JTAG_DATA_SHIFT:
-		LOG_DBG("Received 1S JTAG Data Shift command");
-		OEM_1S_JTAG_DATA_SHIFT(msg);
-		break;
+	{ CMD_OEM_1S_SET_JTAG_TAP_STA, OEM_1S_SET_JTAG_TAP_STA,
+	  IPMI_CMD_CLASS_DEVICE, 2, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_OEM_1S_JTAG_DATA_SHIFT, OEM_1S_JTAG_DATA_SHIFT,
+	  IPMI_CMD_CLASS_DEVICE, 5, IPMI_CMD_PRIV_ADMIN },
 #ifdef ENABLE_ASD
-	case CMD_OEM_1S_ASD_INIT:
-		LOG_DBG("Received 1S ASD Initialize command");
-		OEM_1S_ASD_INIT(msg);
-		break;
+	{ CMD_OEM_1S_ASD_INIT, OEM_1S_ASD_INIT, IPMI_CMD_CLASS_FAST, 1 },
 #endif
 #endif
 #ifdef ENABLE_FAN
-	case CMD_OEM_1S_SET_FAN_DUTY_AUTO:
-		LOG_DBG("Received 1S Set Fan Duty (Auto) command");
-		OEM_1S_SET_FAN_DUTY_AUTO(msg);
-		break;
-	case CMD_OEM_1S_GET_FAN_DUTY:
-		LOG_DBG("Received 1S Get Fan Duty command");
-		OEM_1S_GET_FAN_DUTY(msg);
-		break;
-	case CMD_OEM_1S_GET_FAN_RPM:
-		LOG_DBG("Received 1S Get Fan RPM command");
-		OEM_1S_GET_FAN_RPM(msg);
-		break;
+	{ CMD_OEM_1S_SET_FAN_DUTY_AUTO, OEM_1S_SET_FAN_DUTY_AUTO, IPMI_CMD_CLASS_FAST, 2 },
+	{ CMD_OEM_1S_GET_FAN_DUTY, OEM_1S_GET_FAN_DUTY, IPMI_CMD_CLASS_FAST, 1 },
+	{ CMD_OEM_1S_GET_FAN_RPM, OEM_1S_GET_FAN_RPM, IPMI_CMD_CLASS_FAST, 1 },
 #endif
-	case CMD_OEM_1S_COPY_FLASH_IMAGE:
-		LOG_DBG("Received 1S Copy Flash Image command");
-		OEM_1S_COPY_FLASH_IMAGE(msg);
-		break;
-	case CMD_GET_COPY_FLASH_STATUS:
-		LOG_DBG("Received 1S Get Copy Flash Status command");
-		GET_COPY_FLASH_STATUS(msg);
-		break;
-	case CMD_OEM_1S_INFORM_PEER_SLED_CYCLE:
-		LOG_DBG("Received 1S Inform Peer Sled-cycle command");
-		OEM_1S_INFORM_PEER_SLED_CYCLE(msg);
-		break;
-	case CMD_OEM_1S_PEX_FLASH_READ:
-		LOG_DBG("Received 1S Read PEX Flash command");
-		OEM_1S_PEX_FLASH_READ(msg);
-		break;
-	case CMD_OEM_1S_GET_FPGA_USER_CODE:
-		LOG_DBG("Received 1S Get FPGA User Code command");
-		OEM_1S_GET_FPGA_USER_CODE(msg);
-		break;
-	case CMD_OEM_1S_GET_BOARD_ID:
-		LOG_DBG("Received 1S Get Board ID command");
-		OEM_1S_GET_BOARD_ID(msg);
-		break;
-	case CMD_OEM_1S_GET_CARD_TYPE:
-		LOG_DBG("Received 1S Get Card Type command");
-		OEM_1S_GET_CARD_TYPE(msg);
-		break;
-	case CMD_OEM_1S_MULTI_ACCURACY_SENSOR_READING:
-		LOG_DBG("Received 1S Multi-accuracy Sensor Read command");
-		OEM_1S_MULTI_ACCURACY_SENSOR_READING(msg);
-		break;
-	case CMD_OEM_1S_BRIDGE_I2C_MSG_BY_COMPNT:
-		LOG_DBG("Received 1S Bridge I2C Message by Component command");
-		OEM_1S_BRIDGE_I2C_MSG_BY_COMPNT(msg);
-		break;
-	case CMD_OEM_1S_NOTIFY_PMIC_ERROR:
-		LOG_DBG("Received 1S Notify PMIC Error command");
-		OEM_1S_NOTIFY_PMIC_ERROR(msg);
-		break;
-	case CMD_OEM_1S_GET_SDR:
-		LOG_DBG("Received 1S Get SDR command");
-		OEM_1S_GET_SDR(msg);
-		break;
-	case CMD_OEM_1S_BMC_IPMB_ACCESS:
-		LOG_DBG("Received 1S BMC IPMB Access command");
-		OEM_1S_BMC_IPMB_ACCESS(msg);
-		break;
-	case CMD_OEM_1S_GET_BIOS_VERSION:
-		LOG_DBG("Received 1S Get BIOS version command");
-		OEM_1S_GET_BIOS_VERSION(msg);
-		break;
-	case CMD_OEM_1S_GET_PCIE_CARD_STATUS:
-		LOG_DBG("Received 1S Get PCIE card status command");
-		OEM_1S_GET_PCIE_CARD_STATUS(msg);
-		break;
-	case CMD_OEM_1S_GET_PCIE_CARD_SENSOR_READING:
-		LOG_DBG("Received 1S Get PCIE card sensor reading command");
-		OEM_1S_GET_PCIE_CARD_SENSOR_READING(msg);
-		break;
+	{ CMD_OEM_1S_COPY_FLASH_IMAGE, OEM_1S_COPY_FLASH_IMAGE,
+	  IPMI_CMD_CLASS_LONG, 0, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_GET_COPY_FLASH_STATUS, GET_COPY_FLASH_STATUS },
+	{ CMD_OEM_1S_INFORM_PEER_SLED_CYCLE, OEM_1S_INFORM_PEER_SLED_CYCLE },
+	{ CMD_OEM_1S_PEX_FLASH_READ, OEM_1S_PEX_FLASH_READ, IPMI_CMD_CLASS_LONG },
+	{ CMD_OEM_1S_GET_FPGA_USER_CODE, OEM_1S_GET_FPGA_USER_CODE },
+	{ CMD_OEM_1S_GET_BOARD_ID, OEM_1S_GET_BOARD_ID },
+	{ CMD_OEM_1S_GET_CARD_TYPE, OEM_1S_GET_CARD_TYPE },
+	{ CMD_OEM_1S_MULTI_ACCURACY_SENSOR_READING, OEM_1S_MULTI_ACCURACY_SENSOR_READING },
+	{ CMD_OEM_1S_GET_SENSOR_HISTORY, OEM_1S_GET_SENSOR_HISTORY, IPMI_CMD_CLASS_FAST, 6 },
+	{ CMD_OEM_1S_GET_IPMI_CMD_STAT, OEM_1S_GET_IPMI_CMD_STAT, IPMI_CMD_CLASS_FAST, 2 },
+	{ CMD_OEM_1S_BRIDGE_I2C_MSG_BY_COMPNT, OEM_1S_BRIDGE_I2C_MSG_BY_COMPNT,
+	  IPMI_CMD_CLASS_DEVICE, 0, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_OEM_1S_NOTIFY_PMIC_ERROR, OEM_1S_NOTIFY_PMIC_ERROR, IPMI_CMD_CLASS_FAST, 2 },
+	{ CMD_OEM_1S_GET_SDR, OEM_1S_GET_SDR, IPMI_CMD_CLASS_FAST, 6 },
+	{ CMD_OEM_1S_BMC_IPMB_ACCESS, OEM_1S_BMC_IPMB_ACCESS,
+	  IPMI_CMD_CLASS_DEVICE, 2, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_OEM_1S_GET_BIOS_VERSION, OEM_1S_GET_BIOS_VERSION },
+	{ CMD_OEM_1S_GET_PCIE_CARD_STATUS, OEM_1S_GET_PCIE_CARD_STATUS },
+	{ CMD_OEM_1S_GET_PCIE_CARD_SENSOR_READING, OEM_1S_GET_PCIE_CARD_SENSOR_READING },
 #ifdef CONFIG_I3C_ASPEED
-	case CMD_OEM_1S_WRITE_READ_DIMM:
-		LOG_DBG("Received 1S write read dimm information command");
-		OEM_1S_WRITE_READ_DIMM(msg);
-		break;
+	{ CMD_OEM_1S_WRITE_READ_DIMM, OEM_1S_WRITE_READ_DIMM,
+	  IPMI_CMD_CLASS_DEVICE, 0, IPMI_CMD_PRIV_ADMIN },
 #endif
-	case CMD_OEM_1S_GET_DIMM_I3C_MUX_SELECTION:
-		LOG_DBG("Received 1S Get DIMM I3C MUX selection command");
-		OEM_1S_GET_DIMM_I3C_MUX_SELECTION(msg);
-		break;
-	default:
-		LOG_ERR("Invalid OEM message, netfn(0x%x) cmd(0x%x)", msg->netfn, msg->cmd);
-		msg->data_len = 0;
-		msg->completion_code = CC_INVALID_CMD;
-		break;
-	}
-	return;
+	{ CMD_OEM_1S_GET_DIMM_I3C_MUX_SELECTION, OEM_1S_GET_DIMM_I3C_MUX_SELECTION },
+};
+
+void oem_1s_cmd_register(void)
+{
+	ipmi_cmd_register_table(NETFN_OEM_1S_REQ, oem_1s_cmd_table, ARRAY_SIZE(oem_1s_cmd_table));
 }
@@ -15,6 +15,7 @@
  */
 
 #include "oem_handler.h"
+#include "ipmi_cmd_table.h"
 
 #include "sensor.h"
 #include "plat_sensor_table.h"
@@ -276,44 +277,21 @@ __weak void OEM_CABLE_DETECTION(ipmi_msg *msg)
 	return;
 }
 
-void IPMI_OEM_handler(ipmi_msg *msg)
-{
-	CHECK_NULL_ARG(msg);
-
-	switch (msg->cmd) {
-	case CMD_OEM_CABLE_DETECTION:
-		LOG_DBG("Received Cable Detect command");
-		OEM_CABLE_DETECTION(msg);
-		break;
+static const ipmi_cmd_entry oem_cmd_table[] = {
+	{ CMD_OEM_CABLE_DETECTION, OEM_CABLE_DETECTION },
 #ifdef CONFIG_ESPI
-	case CMD_OEM_NM_SENSOR_READ:
-		LOG_DBG("Received NM Sensor Read command");
-		OEM_NM_SENSOR_READ(msg);
-		break;
-	case CMD_OEM_SET_SYSTEM_GUID:
-		LOG_DBG("Received Set System GUID command");
-		OEM_SET_SYSTEM_GUID(msg);
-		break;
+	{ CMD_OEM_NM_SENSOR_READ, OEM_NM_SENSOR_READ, IPMI_CMD_CLASS_FAST, 3 },
+	{ CMD_OEM_SET_SYSTEM_GUID, OEM_SET_SYSTEM_GUID,
+	  IPMI_CMD_CLASS_FAST, 16, IPMI_CMD_PRIV_ADMIN },
 #endif
 #ifdef ENABLE_FAN
-	case CMD_OEM_SET_FAN_DUTY_MANUAL:
-		LOG_DBG("Received Set Fan Duty (manual) command");
-		OEM_SET_FAN_DUTY_MANUAL(msg);
-		break;
-	case CMD_OEM_GET_SET_FAN_CTRL_MODE:
-		LOG_DBG("Received Set Fan Control Mode command");
-		OEM_GET_SET_FAN_CTRL_MODE(msg);
-		break;
+	{ CMD_OEM_SET_FAN_DUTY_MANUAL, OEM_SET_FAN_DUTY_MANUAL, IPMI_CMD_CLASS_FAST, 2 },
+	{ CMD_OEM_GET_SET_FAN_CTRL_MODE, OEM_GET_SET_FAN_CTRL_MODE, IPMI_CMD_CLASS_FAST, 1 },
 #endif
-	case CMD_OEM_GET_MB_INDEX:
-		LOG_DBG("Received Get MB Index command");
-		OEM_GET_MB_INDEX(msg);
-		break;
-	default:
-		LOG_ERR("invalid OEM msg netfn: %x, cmd: %x", msg->netfn, msg->cmd);
-		msg->data_len = 0;
-		msg->completion_code = CC_INVALID_CMD;
-		break;
-	}
-	return;
+	{ CMD_OEM_GET_MB_INDEX, OEM_GET_MB_INDEX },
+};
+
+void oem_cmd_register(void)
+{
+	ipmi_cmd_register_table(NETFN_OEM_REQ, oem_cmd_table, ARRAY_SIZE(oem_cmd_table));
 }
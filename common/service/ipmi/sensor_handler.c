@@ -15,8 +15,10 @@
  */
 
 #include "sensor_handler.h"
+#include "ipmi_cmd_table.h"
 
 #include "sensor.h"
+#include "sensor_threshold.h"
 #include <logging/log.h>
 #include "libutil.h"
 
@@ -44,6 +46,7 @@ __weak void SENSOR_GET_SENSOR_READING(ipmi_msg *msg)
 		status = SENSOR_POLLING_DISABLE;
 	}
 
+	uint8_t sensor_num = msg->data[0];
 	sensor_val *sval = (sensor_val *)(&reading);
 	switch (status) {
 	case SENSOR_READ_SUCCESS:
@@ -53,8 +56,8 @@ __weak void SENSOR_GET_SENSOR_READING(ipmi_msg *msg)
 					     (int)((sval->integer * 1000) + sval->fraction)) /
 			       1000;
 		msg->data[1] = sensor_report_status;
-		// fix to threshold deassert status, BMC will compare with UCR/UNR itself
-		msg->data[2] = SENSOR_THRESHOLD_STATUS;
+		// threshold comparison status evaluated on each sensor poll
+		msg->data[2] = SENSOR_THRESHOLD_STATUS | get_sensor_threshold_status(sensor_num);
 		msg->data_len = 3;
 		msg->completion_code = CC_SUCCESS;
 		break;
@@ -89,19 +92,11 @@ __weak void SENSOR_GET_SENSOR_READING(ipmi_msg *msg)
 	return;
 }
 
-void IPMI_SENSOR_handler(ipmi_msg *msg)
-{
-	CHECK_NULL_ARG(msg);
+static const ipmi_cmd_entry sensor_cmd_table[] = {
+	{ CMD_SENSOR_GET_SENSOR_READING, SENSOR_GET_SENSOR_READING, IPMI_CMD_CLASS_FAST, 1 },
+};
 
-	switch (msg->cmd) {
-	case CMD_SENSOR_GET_SENSOR_READING:
-		SENSOR_GET_SENSOR_READING(msg);
-		break;
-	default:
-		LOG_ERR("invalid sensor msg netfn: %x, cmd: %x", msg->netfn, msg->cmd);
-		msg->data_len = 0;
-		msg->completion_code = CC_INVALID_CMD;
-		break;
-	}
-	return;
+void sensor_cmd_register(void)
+{
+	ipmi_cmd_register_table(NETFN_SENSOR_REQ, sensor_cmd_table, ARRAY_SIZE(sensor_cmd_table));
 }
@@ -16,6 +16,8 @@
 
 #include <stdlib.h>
 #include "storage_handler.h"
+#include "ipmi_cmd_table.h"
+#include "ipmi_msg_pool.h"
 #include "plat_fru.h"
 #include "plat_ipmb.h"
 #include "fru.h"
@@ -265,7 +267,7 @@ __weak void STORAGE_ADD_SEL(ipmi_msg *msg)
 	ipmb_error status;
 	ipmi_msg *add_sel_msg;
 
-	add_sel_msg = (ipmi_msg *)malloc(sizeof(ipmi_msg));
+	add_sel_msg = (ipmi_msg *)ipmi_msg_pool_alloc(K_NO_WAIT);
 	if (add_sel_msg == NULL) {
 		LOG_ERR("Storge add sel msg malloc fail");
 		msg->completion_code = CC_UNSPECIFIED_ERROR;
@@ -285,7 +287,7 @@ __weak void STORAGE_ADD_SEL(ipmi_msg *msg)
 	memcpy(add_sel_msg->data, msg->data, add_sel_msg->data_len);
 
 	status = ipmb_read(add_sel_msg, IPMB_inf_index_map[add_sel_msg->InF_target]);
-	free(add_sel_msg);
+	SAFE_IPMI_MSG_FREE(add_sel_msg);
 
 	msg->data_len = 0;
 	if (status == IPMB_ERROR_FAILURE) {
@@ -305,34 +307,18 @@ __weak void STORAGE_ADD_SEL(ipmi_msg *msg)
 	return;
 }
 
-void IPMI_Storage_handler(ipmi_msg *msg)
+static const ipmi_cmd_entry storage_cmd_table[] = {
+	{ CMD_STORAGE_GET_FRUID_INFO, STORAGE_GET_FRUID_INFO, IPMI_CMD_CLASS_FAST, 1 },
+	{ CMD_STORAGE_READ_FRUID_DATA, STORAGE_READ_FRUID_DATA, IPMI_CMD_CLASS_DEVICE, 4 },
+	{ CMD_STORAGE_WRITE_FRUID_DATA, STORAGE_WRITE_FRUID_DATA,
+	  IPMI_CMD_CLASS_DEVICE, 4, IPMI_CMD_PRIV_ADMIN },
+	{ CMD_STORAGE_RSV_SDR, STORAGE_RSV_SDR },
+	{ CMD_STORAGE_GET_SDR, STORAGE_GET_SDR, IPMI_CMD_CLASS_FAST, 6 },
+	{ CMD_STORAGE_ADD_SEL, STORAGE_ADD_SEL, IPMI_CMD_CLASS_FAST, 16 },
+};
+
+void storage_cmd_register(void)
 {
-	CHECK_NULL_ARG(msg);
-
-	switch (msg->cmd) {
-	case CMD_STORAGE_GET_FRUID_INFO:
-		STORAGE_GET_FRUID_INFO(msg);
-		break;
-	case CMD_STORAGE_READ_FRUID_DATA:
-		STORAGE_READ_FRUID_DATA(msg);
-		break;
-	case CMD_STORAGE_WRITE_FRUID_DATA:
-		STORAGE_WRITE_FRUID_DATA(msg);
-		break;
-	case CMD_STORAGE_RSV_SDR:
-		STORAGE_RSV_SDR(msg);
-		break;
-	case CMD_STORAGE_GET_SDR:
-		STORAGE_GET_SDR(msg);
-		break;
-	case CMD_STORAGE_ADD_SEL:
-		STORAGE_ADD_SEL(msg);
-		break;
-	default:
-		LOG_ERR("invalid Storage msg netfn: %x, cmd: %x", msg->netfn, msg->cmd);
-		msg->data_len = 0;
-		msg->completion_code = CC_INVALID_CMD;
-		break;
-	}
-	return;
+	ipmi_cmd_register_table(NETFN_STORAGE_REQ, storage_cmd_table,
+				ARRAY_SIZE(storage_cmd_table));
 }
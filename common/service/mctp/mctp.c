@@ -15,6 +15,7 @@
  */
 
 #include "mctp.h"
+#include "mctp_pending.h"
 #include <logging/log.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -26,6 +27,22 @@
 
 LOG_MODULE_REGISTER(mctp);
 
+#ifndef MCTP_ASSEMBLY_BUF_SIZE
+#define MCTP_ASSEMBLY_BUF_SIZE MCTP_ASSEMBLY_BUF_SIZE_DEFAULT
+#endif
+
+#ifndef MCTP_ASSEMBLY_POOL_NUM
+#define MCTP_ASSEMBLY_POOL_NUM MCTP_ASSEMBLY_POOL_NUM_DEFAULT
+#endif
+
+#ifndef MCTP_DISPATCH_STACK_SIZE
+#define MCTP_DISPATCH_STACK_SIZE MCTP_DISPATCH_STACK_SIZE_DEFAULT
+#endif
+
+#ifndef MCTP_PACKET_POOL_NUM
+#define MCTP_PACKET_POOL_NUM MCTP_PACKET_POOL_NUM_DEFAULT
+#endif
+
 typedef struct __attribute__((packed)) {
 	uint8_t hdr_ver;
 	uint8_t dest_ep;
@@ -42,6 +59,45 @@ typedef struct __attribute__((packed)) {
 	};
 } mctp_hdr;
 
+K_MEM_SLAB_DEFINE(mctp_assembly_slab, MCTP_ASSEMBLY_BUF_SIZE, MCTP_ASSEMBLY_POOL_NUM, 4);
+K_MEM_SLAB_DEFINE(mctp_tx_slab, MCTP_TX_BUF_SIZE, MCTP_TX_POOL_NUM, 4);
+
+#define MCTP_PACKET_BUF_SIZE 256
+#define MCTP_HDR_MSG_TYPE_MASK 0x7F
+
+enum MCTP_DISPATCH_WORKER {
+	MCTP_DISPATCH_CTRL,
+	MCTP_DISPATCH_PLDM,
+	MCTP_DISPATCH_CCI,
+	MCTP_DISPATCH_VENDOR,
+	MCTP_DISPATCH_WORKER_MAX,
+};
+
+typedef struct __attribute__((aligned(4))) _mctp_dispatch_msg {
+	mctp *mctp_inst;
+	uint8_t *buf;
+	uint16_t len;
+	uint8_t is_packet_buf; /* buf is from mctp_packet_slab, otherwise mctp_assembly_slab */
+	mctp_ext_params ext_params;
+} mctp_dispatch_msg;
+
+static const char *const mctp_dispatch_name[MCTP_DISPATCH_WORKER_MAX] = {
+	"mctp_ctrl",
+	"mctp_pldm",
+	"mctp_cci",
+	"mctp_vendor",
+};
+
+typedef struct _mctp_dispatch_worker {
+	struct k_thread thread;
+	K_KERNEL_STACK_MEMBER(stack, MCTP_DISPATCH_STACK_SIZE);
+	struct k_msgq queue;
+	mctp_dispatch_msg queue_buf[MCTP_DISPATCH_QUEUE_SIZE];
+} mctp_dispatch_worker;
+
+static mctp_dispatch_worker *dispatch_worker;
+static struct k_mem_slab mctp_packet_slab;
+
 /* set thread name */
 static uint8_t set_thread_name(mctp *mctp_inst)
 {
@@ -143,43 +199,202 @@ static uint8_t bridge_msg(mctp *mctp_inst, uint8_t *buf, uint16_t len)
 	return mctp_bridge_msg(target_mctp, buf, len, target_ext_params);
 }
 
-static uint8_t mctp_pkt_assembling(mctp *mctp_inst, uint8_t *buf, uint16_t len)
+static void release_assembly(mctp_assembly *assembly)
 {
-	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, MCTP_ERROR);
-	CHECK_NULL_ARG_WITH_RETURN(buf, MCTP_ERROR);
-	CHECK_ARG_WITH_RETURN(!len, MCTP_ERROR);
+	CHECK_NULL_ARG(assembly);
+
+	if (assembly->buf) {
+		k_mem_slab_free(&mctp_assembly_slab, (void **)&assembly->buf);
+		assembly->buf = NULL;
+	}
+	assembly->offset = 0;
+}
+
+/* Find the assembling message of the packet, or a free entry if there is none. Messages which got
+ * no packet in MCTP_ASSEMBLY_TIMEOUT_MS are dropped on the way.
+ */
+static mctp_assembly *find_assembly(mctp *mctp_inst, mctp_hdr *hdr)
+{
+	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, NULL);
+	CHECK_NULL_ARG_WITH_RETURN(hdr, NULL);
+
+	mctp_assembly *free_assembly = NULL;
+	int64_t now = k_uptime_get();
+	uint8_t i;
+
+	for (i = 0; i < MCTP_ASSEMBLY_NUM; i++) {
+		mctp_assembly *assembly = &mctp_inst->assembly[i];
+		if (assembly->buf && (now > assembly->deadline)) {
+			LOG_WRN("Drop incomplete message from endpoint 0x%x, tag %d",
+				assembly->src_ep, assembly->msg_tag);
+			release_assembly(assembly);
+		}
+
+		if (!assembly->buf) {
+			if (!free_assembly)
+				free_assembly = assembly;
+			continue;
+		}
+
+		if ((assembly->src_ep == hdr->src_ep) && (assembly->tag_owner == hdr->to) &&
+		    (assembly->msg_tag == hdr->msg_tag))
+			return assembly;
+	}
+
+	return free_assembly;
+}
+
+static mctp_assembly *mctp_pkt_assembling(mctp *mctp_inst, uint8_t *buf, uint16_t len)
+{
+	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, NULL);
+	CHECK_NULL_ARG_WITH_RETURN(buf, NULL);
+	CHECK_ARG_WITH_RETURN(len <= sizeof(mctp_hdr), NULL);
 
 	mctp_hdr *hdr = (mctp_hdr *)buf;
-	uint8_t **buf_p = &mctp_inst->temp_msg_buf[hdr->msg_tag].buf;
-	uint16_t *offset_p = &mctp_inst->temp_msg_buf[hdr->msg_tag].offset;
+	mctp_assembly *assembly = find_assembly(mctp_inst, hdr);
+	if (!assembly) {
+		LOG_WRN("No free assembly entry for endpoint 0x%x", hdr->src_ep);
+		return NULL;
+	}
 
-	/* one packet message, do nothing */
-	if (hdr->som && hdr->eom)
-		return MCTP_SUCCESS;
 	/* first packet, allocate memory to hold data */
-	if (hdr->som && !hdr->eom) {
-		if (*buf_p) {
+	if (hdr->som) {
+		if (assembly->buf) {
 			LOG_WRN("Unexpected SOM received?");
-			free(*buf_p);
+			release_assembly(assembly);
 		}
-		*offset_p = 0;
 
-		*buf_p = (uint8_t *)malloc(MSG_ASSEMBLY_BUF_SIZE);
-		if (!*buf_p) {
+		if (k_mem_slab_alloc(&mctp_assembly_slab, (void **)&assembly->buf, K_NO_WAIT)) {
 			LOG_WRN("cannot create memory...");
-			return MCTP_ERROR;
+			assembly->buf = NULL;
+			return NULL;
 		}
-		memset(*buf_p, 0, MSG_ASSEMBLY_BUF_SIZE);
+		assembly->src_ep = hdr->src_ep;
+		assembly->tag_owner = hdr->to;
+		assembly->msg_tag = hdr->msg_tag;
+		assembly->next_seq = hdr->pkt_seq;
 	}
 
-	if (!(*buf_p)) {
+	if (!assembly->buf) {
 		LOG_HEXDUMP_WRN(buf, len, "There was no SOM package before?");
-		return MCTP_ERROR;
+		return NULL;
+	}
+
+	if (hdr->pkt_seq != assembly->next_seq) {
+		LOG_WRN("Endpoint 0x%x tag %d packet sequence %d, expect %d", hdr->src_ep,
+			hdr->msg_tag, hdr->pkt_seq, assembly->next_seq);
+		release_assembly(assembly);
+		return NULL;
+	}
+
+	uint16_t data_len = len - sizeof(mctp_hdr);
+	if ((assembly->offset + data_len) > MCTP_ASSEMBLY_BUF_SIZE) {
+		LOG_WRN("Endpoint 0x%x tag %d message over %d bytes", hdr->src_ep, hdr->msg_tag,
+			MCTP_ASSEMBLY_BUF_SIZE);
+		release_assembly(assembly);
+		return NULL;
 	}
 
 	/* Appending other packet after the first packet */
-	memcpy(*buf_p + *offset_p, buf + sizeof(hdr), len - sizeof(hdr));
-	*offset_p += len - sizeof(hdr);
+	memcpy(assembly->buf + assembly->offset, buf + sizeof(mctp_hdr), data_len);
+	assembly->offset += data_len;
+	assembly->next_seq = (hdr->pkt_seq + 1) & MCTP_HDR_SEQ_MASK;
+	assembly->deadline = k_uptime_get() + MCTP_ASSEMBLY_TIMEOUT_MS;
+
+	return assembly;
+}
+
+static void mctp_dispatch_msg_free(mctp_dispatch_msg *msg)
+{
+	CHECK_NULL_ARG(msg);
+
+	if (msg->is_packet_buf)
+		k_mem_slab_free(&mctp_packet_slab, (void **)&msg->buf);
+	else
+		k_mem_slab_free(&mctp_assembly_slab, (void **)&msg->buf);
+	msg->buf = NULL;
+}
+
+static uint8_t get_dispatch_worker(uint8_t msg_type)
+{
+	switch (msg_type & MCTP_HDR_MSG_TYPE_MASK) {
+	case MCTP_MSG_TYPE_CTRL:
+		return MCTP_DISPATCH_CTRL;
+	case MCTP_MSG_TYPE_PLDM:
+		return MCTP_DISPATCH_PLDM;
+	case MCTP_MSG_TYPE_CCI:
+		return MCTP_DISPATCH_CCI;
+	default:
+		return MCTP_DISPATCH_VENDOR;
+	}
+}
+
+/* Queue the message to the worker of its message type, buf is released here if it fails */
+static uint8_t mctp_dispatch(mctp_dispatch_msg *msg)
+{
+	CHECK_NULL_ARG_WITH_RETURN(msg, MCTP_ERROR);
+
+	uint8_t worker = get_dispatch_worker(msg->buf[0]);
+	if (k_msgq_put(&dispatch_worker[worker].queue, msg, K_NO_WAIT)) {
+		LOG_WRN("%s queue full, drop message from endpoint 0x%x",
+			mctp_dispatch_name[worker], msg->ext_params.ep);
+		mctp_dispatch_msg_free(msg);
+		return MCTP_ERROR;
+	}
+
+	return MCTP_SUCCESS;
+}
+
+static void mctp_dispatch_task(void *arg, void *dummy0, void *dummy1)
+{
+	ARG_UNUSED(dummy0);
+	ARG_UNUSED(dummy1);
+
+	uint8_t worker = POINTER_TO_UINT(arg);
+
+	while (1) {
+		mctp_dispatch_msg msg;
+		if (k_msgq_get(&dispatch_worker[worker].queue, &msg, K_FOREVER))
+			continue;
+
+		LOG_HEXDUMP_DBG(msg.buf, msg.len, "mctp dispatch data");
+
+		mctp *mctp_inst = msg.mctp_inst;
+		if (mctp_inst->rx_cb)
+			mctp_inst->rx_cb(mctp_inst, msg.buf, msg.len, msg.ext_params);
+
+		mctp_dispatch_msg_free(&msg);
+	}
+}
+
+/* workers are shared by all mctp instances and started with the first one */
+static uint8_t mctp_dispatch_start(void)
+{
+	if (dispatch_worker)
+		return MCTP_SUCCESS;
+
+	uint8_t *packet_buf = (uint8_t *)malloc(MCTP_PACKET_POOL_NUM * MCTP_PACKET_BUF_SIZE);
+	mctp_dispatch_worker *worker =
+		(mctp_dispatch_worker *)malloc(MCTP_DISPATCH_WORKER_MAX * sizeof(*worker));
+	if (!packet_buf || !worker) {
+		LOG_ERR("mctp dispatch alloc failed");
+		free(packet_buf);
+		free(worker);
+		return MCTP_ERROR;
+	}
+
+	k_mem_slab_init(&mctp_packet_slab, packet_buf, MCTP_PACKET_BUF_SIZE, MCTP_PACKET_POOL_NUM);
+	dispatch_worker = worker;
+	mctp_pending_init();
+
+	for (uint8_t i = 0; i < MCTP_DISPATCH_WORKER_MAX; i++) {
+		k_msgq_init(&worker[i].queue, (char *)worker[i].queue_buf,
+			    sizeof(mctp_dispatch_msg), MCTP_DISPATCH_QUEUE_SIZE);
+		k_thread_create(&worker[i].thread, worker[i].stack,
+				K_KERNEL_STACK_SIZEOF(worker[i].stack), mctp_dispatch_task,
+				UINT_TO_POINTER(i), NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+		k_thread_name_set(&worker[i].thread, mctp_dispatch_name[i]);
+	}
 
 	return MCTP_SUCCESS;
 }
@@ -200,8 +415,7 @@ static void mctp_rx_task(void *arg, void *dummy0, void *dummy1)
 	LOG_INF("mctp_rx_task start %p", mctp_inst);
 
 	while (1) {
-		k_msleep(MCTP_POLL_TIME_MS);
-		uint8_t read_buf[256] = { 0 };
+		uint8_t read_buf[MCTP_PACKET_BUF_SIZE] = { 0 };
 		mctp_ext_params ext_params;
 		uint8_t ret = MCTP_ERROR;
 		memset(&ext_params, 0, sizeof(ext_params));
@@ -237,156 +451,204 @@ static void mctp_rx_task(void *arg, void *dummy0, void *dummy1)
 
 		/* handle this packet by self */
 
-		/* assembling the mctp message */
-		if (mctp_pkt_assembling(mctp_inst, read_buf, read_len) == MCTP_ERROR)
-			LOG_WRN("Packet assemble failed ");
+		/* assembling the mctp message, one packet message is handled in place */
+		mctp_assembly *assembly = NULL;
+		if (!(hdr->som && hdr->eom)) {
+			assembly = mctp_pkt_assembling(mctp_inst, read_buf, read_len);
+			if (!assembly) {
+				LOG_WRN("Packet assemble failed ");
+				continue;
+			}
+		}
 
 		/* if it is not last packet, waiting for the remain data */
 		if (!hdr->eom)
 			continue;
 
-		if (mctp_inst->rx_cb) {
-			/* default process read data buffer directly */
-			uint8_t *p = read_buf + sizeof(hdr);
-			uint16_t len = read_len - sizeof(hdr);
-			/* this is assembly message */
-			if (mctp_inst->temp_msg_buf[hdr->msg_tag].buf) {
-				p = mctp_inst->temp_msg_buf[hdr->msg_tag].buf;
-				len = mctp_inst->temp_msg_buf[hdr->msg_tag].offset;
+		if (!mctp_inst->rx_cb) {
+			if (assembly)
+				release_assembly(assembly);
+			continue;
+		}
 
-				LOG_HEXDUMP_DBG(p, len, "mctp assembly data");
+		/* responses only complete pending requests, handle them here so a worker waiting
+		 * for a response never waits for itself
+		 */
+		if (!hdr->to) {
+			if (assembly) {
+				mctp_inst->rx_cb(mctp_inst, assembly->buf, assembly->offset,
+						 ext_params);
+				release_assembly(assembly);
+			} else if (read_len > sizeof(mctp_hdr)) {
+				mctp_inst->rx_cb(mctp_inst, read_buf + sizeof(mctp_hdr),
+						 read_len - sizeof(mctp_hdr), ext_params);
 			}
-
-			/* handle the mctp messsage */
-			mctp_inst->rx_cb(mctp_inst, p, len, ext_params);
+			continue;
 		}
 
-		if (mctp_inst->temp_msg_buf[hdr->msg_tag].buf) {
-			free(mctp_inst->temp_msg_buf[hdr->msg_tag].buf);
-			mctp_inst->temp_msg_buf[hdr->msg_tag].buf = NULL;
-			mctp_inst->temp_msg_buf[hdr->msg_tag].offset = 0;
+		mctp_dispatch_msg msg = { 0 };
+		msg.mctp_inst = mctp_inst;
+		msg.ext_params = ext_params;
+		if (assembly) {
+			/* hand the assembly buffer over to the worker */
+			msg.buf = assembly->buf;
+			msg.len = assembly->offset;
+			assembly->buf = NULL;
+			release_assembly(assembly);
+		} else {
+			if (read_len <= sizeof(mctp_hdr))
+				continue;
+
+			if (k_mem_slab_alloc(&mctp_packet_slab, (void **)&msg.buf, K_NO_WAIT)) {
+				LOG_WRN("Drop message from endpoint 0x%x, no packet buffer",
+					hdr->src_ep);
+				continue;
+			}
+			msg.is_packet_buf = 1;
+			msg.len = read_len - sizeof(mctp_hdr);
+			memcpy(msg.buf, read_buf + sizeof(mctp_hdr), msg.len);
 		}
+
+		/* handle the mctp messsage in the worker of its message type */
+		mctp_dispatch(&msg);
 	}
 }
 
-static void mctp_tx_task_response(struct k_msgq *msgq, uint8_t resp_code)
+static void mctp_tx_msg_done(mctp_tx_msg *mctp_msg, uint8_t status)
 {
-	CHECK_NULL_ARG(msgq);
+	CHECK_NULL_ARG(mctp_msg);
+
+	if (mctp_msg->buf) {
+		if (mctp_msg->is_pool_buf)
+			mctp_tx_buf_free(mctp_msg->buf);
+		else
+			free(mctp_msg->buf);
+		mctp_msg->buf = NULL;
+	}
 
-	if (k_msgq_put(msgq, &resp_code, K_NO_WAIT))
-		LOG_WRN("mctp tx task response failed");
+	if (mctp_msg->cb)
+		mctp_msg->cb(mctp_msg->cb_args, status);
 }
 
-/* mctp tx task */
-static void mctp_tx_task(void *arg, void *dummy0, void *dummy1)
+/* write one message to the medium and complete it */
+static void mctp_tx_msg_write(mctp *mctp_inst, mctp_tx_msg *mctp_msg)
 {
-	CHECK_NULL_ARG(arg);
-	ARG_UNUSED(dummy0);
-	ARG_UNUSED(dummy1);
+	int ret;
 
-	mctp *mctp_inst = (mctp *)arg;
-
-	if (!mctp_inst->write_data) {
-		LOG_WRN("mctp_tx_task without medium write function!");
+	if (!mctp_msg->buf || !mctp_msg->len) {
+		mctp_tx_msg_done(mctp_msg, MCTP_ERROR);
 		return;
 	}
 
-	LOG_INF("mctp_tx_task start %p ", mctp_inst);
-
-	while (1) {
-		mctp_tx_msg mctp_msg = { 0 };
-		int ret = k_msgq_get(&mctp_inst->mctp_tx_queue, &mctp_msg, K_FOREVER);
-		if (ret)
-			continue;
-
-		if (!mctp_msg.buf) {
-			mctp_tx_task_response(mctp_msg.evt_msgq, MCTP_ERROR);
-			continue;
-		}
-
-		if (!mctp_msg.len) {
-			free(mctp_msg.buf);
-			mctp_tx_task_response(mctp_msg.evt_msgq, MCTP_ERROR);
-			continue;
-		}
-
-		LOG_DBG("tx endpoint %x", mctp_msg.ext_params.ep);
-		LOG_HEXDUMP_DBG(mctp_msg.buf, mctp_msg.len, "mctp tx task receive data");
+	LOG_DBG("tx endpoint %x", mctp_msg->ext_params.ep);
+	LOG_HEXDUMP_DBG(mctp_msg->buf, mctp_msg->len, "mctp tx task receive data");
 
-		/*
+	/*
 * The bridge meesage already has the mctp transport header, and the bridge
      * message also doesn't need to split packet.
 */
-		if (mctp_msg.is_bridge_packet) {
-			ret = mctp_inst->write_data(mctp_inst, mctp_msg.buf, mctp_msg.len,
-						    mctp_msg.ext_params);
-			free(mctp_msg.buf);
-			mctp_tx_task_response(mctp_msg.evt_msgq, ret);
-			continue;
-		}
+	if (mctp_msg->is_bridge_packet) {
+		ret = mctp_inst->write_data(mctp_inst, mctp_msg->buf, mctp_msg->len,
+					    mctp_msg->ext_params);
+		mctp_tx_msg_done(mctp_msg, ret);
+		return;
+	}
 
-		/* Setup MCTP header and send to destination endpoint */
-		static uint8_t msg_tag;
-		uint16_t max_msg_size = mctp_inst->max_msg_size;
-		uint8_t i;
-		uint8_t split_pkt_num =
-			(mctp_msg.len / max_msg_size) + ((mctp_msg.len % max_msg_size) ? 1 : 0);
-		LOG_DBG("mctp_msg.len = %d", mctp_msg.len);
-		LOG_DBG("split_pkt_num = %d", split_pkt_num);
-		for (i = 0; i < split_pkt_num; i++) {
-			uint8_t buf[max_msg_size + MCTP_TRANSPORT_HEADER_SIZE];
-			mctp_hdr *hdr = (mctp_hdr *)buf;
-			uint8_t cp_msg_size = max_msg_size;
-
-			memset(buf, 0, sizeof(buf));
-
-			/* The first packet should set SOM */
-			if (!i)
-				hdr->som = 1;
-
-			/* The last packet should set EOM */
-			if (i == (split_pkt_num - 1)) {
-				hdr->eom = 1;
-				uint8_t remain = mctp_msg.len % max_msg_size;
-				cp_msg_size = remain ? remain : max_msg_size; /* remain data */
-			}
+	/* Setup MCTP header and send to destination endpoint */
+	static uint8_t msg_tag;
+	uint16_t max_msg_size = mctp_inst->max_msg_size;
+	uint8_t i;
+	uint8_t split_pkt_num =
+		(mctp_msg->len / max_msg_size) + ((mctp_msg->len % max_msg_size) ? 1 : 0);
+	uint8_t buf[max_msg_size + MCTP_TRANSPORT_HEADER_SIZE];
+	mctp_hdr *hdr = (mctp_hdr *)buf;
+	LOG_DBG("mctp_msg->len = %d", mctp_msg->len);
+	LOG_DBG("split_pkt_num = %d", split_pkt_num);
+	/* packets are written back to back, the medium write is the only wait here */
+	for (i = 0; i < split_pkt_num; i++) {
+		uint8_t cp_msg_size = max_msg_size;
+
+		memset(hdr, 0, sizeof(*hdr));
+
+		/* The first packet should set SOM */
+		if (!i)
+			hdr->som = 1;
+
+		/* The last packet should set EOM */
+		if (i == (split_pkt_num - 1)) {
+			hdr->eom = 1;
+			uint8_t remain = mctp_msg->len % max_msg_size;
+			cp_msg_size = remain ? remain : max_msg_size; /* remain data */
+		}
 
-			hdr->to = mctp_msg.ext_params.tag_owner;
-			hdr->pkt_seq = i & MCTP_HDR_SEQ_MASK;
+		hdr->to = mctp_msg->ext_params.tag_owner;
+		hdr->pkt_seq = i & MCTP_HDR_SEQ_MASK;
 
-			/*
+		/*
 * TODO: should avoid the msg_tag if there are pending mctp
 * response packets?
        * If the message is response, keep the original msg_tag of ext_params
 */
-			hdr->msg_tag = (hdr->to) ? (msg_tag & MCTP_HDR_TAG_MASK) :
-							 mctp_msg.ext_params.msg_tag;
-
-			hdr->dest_ep = mctp_msg.ext_params.ep;
-			hdr->src_ep = mctp_inst->endpoint;
-			hdr->hdr_ver = MCTP_HDR_HDR_VER;
-
-			LOG_DBG("i = %d, cp_msg_size = %d", i, cp_msg_size);
-			LOG_DBG("hdr->flags_seq_to_tag = %x", hdr->flags_seq_to_tag);
-			memcpy(buf + MCTP_TRANSPORT_HEADER_SIZE, mctp_msg.buf + i * max_msg_size,
-			       cp_msg_size);
-			ret = mctp_inst->write_data(mctp_inst, buf,
-						    cp_msg_size + MCTP_TRANSPORT_HEADER_SIZE,
-						    mctp_msg.ext_params);
-
-			if (ret != MCTP_SUCCESS) {
-				LOG_WRN("mctp write data failed");
-				break;
-			}
+		hdr->msg_tag = (hdr->to) ? (msg_tag & MCTP_HDR_TAG_MASK) :
+						 mctp_msg->ext_params.msg_tag;
+
+		hdr->dest_ep = mctp_msg->ext_params.ep;
+		hdr->src_ep = mctp_inst->endpoint;
+		hdr->hdr_ver = MCTP_HDR_HDR_VER;
+
+		LOG_DBG("i = %d, cp_msg_size = %d", i, cp_msg_size);
+		LOG_DBG("hdr->flags_seq_to_tag = %x", hdr->flags_seq_to_tag);
+		memcpy(buf + MCTP_TRANSPORT_HEADER_SIZE, mctp_msg->buf + i * max_msg_size,
+		       cp_msg_size);
+		ret = mctp_inst->write_data(mctp_inst, buf,
+					    cp_msg_size + MCTP_TRANSPORT_HEADER_SIZE,
+					    mctp_msg->ext_params);
+
+		if (ret != MCTP_SUCCESS) {
+			LOG_WRN("mctp write data failed");
+			break;
 		}
+	}
+
+	mctp_tx_msg_done(mctp_msg, (i == split_pkt_num) ? MCTP_SUCCESS : MCTP_ERROR);
 
-		free(mctp_msg.buf);
-		mctp_tx_task_response(mctp_msg.evt_msgq,
-				      (i == split_pkt_num) ? MCTP_SUCCESS : MCTP_ERROR);
+	/* Only request mctp message needs to increase msg_tag */
+	if (mctp_msg->ext_params.tag_owner)
+		msg_tag++;
+}
 
-		/* Only request mctp message needs to increase msg_tag */
-		if (mctp_msg.ext_params.tag_owner)
-			msg_tag++;
+/* mctp tx task */
+static void mctp_tx_task(void *arg, void *dummy0, void *dummy1)
+{
+	CHECK_NULL_ARG(arg);
+	ARG_UNUSED(dummy0);
+	ARG_UNUSED(dummy1);
+
+	mctp *mctp_inst = (mctp *)arg;
+
+	if (!mctp_inst->write_data) {
+		LOG_WRN("mctp_tx_task without medium write function!");
+		return;
+	}
+
+	LOG_INF("mctp_tx_task start %p ", mctp_inst);
+
+	struct k_poll_event tx_event;
+	k_poll_event_init(&tx_event, K_POLL_TYPE_MSGQ_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+			  &mctp_inst->mctp_tx_queue);
+
+	while (1) {
+		tx_event.state = K_POLL_STATE_NOT_READY;
+		k_poll(&tx_event, 1, K_FOREVER);
+
+		/* mctp_stop() takes tx_lock before aborting this task, a dequeued message is always
+		 * completed
+		 */
+		k_mutex_lock(&mctp_inst->tx_lock, K_FOREVER);
+		mctp_tx_msg mctp_msg = { 0 };
+		if (!k_msgq_get(&mctp_inst->mctp_tx_queue, &mctp_msg, K_NO_WAIT))
+			mctp_tx_msg_write(mctp_inst, &mctp_msg);
+		k_mutex_unlock(&mctp_inst->tx_lock);
 	}
 }
 
@@ -402,6 +664,7 @@ mctp *mctp_init(void)
 	mctp_inst->medium_type = MCTP_MEDIUM_TYPE_UNKNOWN;
 	mctp_inst->max_msg_size = MCTP_DEFAULT_MSG_MAX_SIZE;
 	mctp_inst->endpoint = MCTP_DEFAULT_ENDPOINT;
+	k_mutex_init(&mctp_inst->tx_lock);
 
 	LOG_DBG("mctp_inst = %p", mctp_inst);
 	return mctp_inst;
@@ -459,22 +722,34 @@ uint8_t mctp_stop(mctp *mctp_inst)
 {
 	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, MCTP_ERROR);
 
+	/* no more messages are queued from now on */
+	mctp_inst->is_servcie_start = 0;
+
 	if (mctp_inst->mctp_rx_task_tid) {
 		k_thread_abort(mctp_inst->mctp_rx_task_tid);
 		mctp_inst->mctp_rx_task_tid = NULL;
 	}
 
+	for (uint8_t i = 0; i < MCTP_ASSEMBLY_NUM; i++)
+		release_assembly(&mctp_inst->assembly[i]);
+
 	if (mctp_inst->mctp_tx_task_tid) {
+		/* let the tx task finish the message it is writing */
+		k_mutex_lock(&mctp_inst->tx_lock, K_FOREVER);
 		k_thread_abort(mctp_inst->mctp_tx_task_tid);
 		mctp_inst->mctp_tx_task_tid = NULL;
+		k_mutex_unlock(&mctp_inst->tx_lock);
 	}
 
 	if (mctp_inst->mctp_tx_queue.buffer_start) {
+		mctp_tx_msg mctp_msg;
+		while (!k_msgq_get(&mctp_inst->mctp_tx_queue, &mctp_msg, K_NO_WAIT))
+			mctp_tx_msg_done(&mctp_msg, MCTP_ERROR);
+
 		free(mctp_inst->mctp_tx_queue.buffer_start);
 		mctp_inst->mctp_tx_queue.buffer_start = NULL;
 	}
 
-	mctp_inst->is_servcie_start = 0;
 	return MCTP_SUCCESS;
 }
 
@@ -488,6 +763,8 @@ uint8_t mctp_start(mctp *mctp_inst)
 	}
 
 	set_thread_name(mctp_inst);
+	if (mctp_dispatch_start() == MCTP_ERROR)
+		return MCTP_ERROR;
 
 	uint8_t *msgq_buf = (uint8_t *)malloc(MCTP_TX_QUEUE_SIZE * sizeof(mctp_tx_msg));
 	if (!msgq_buf) {
@@ -526,49 +803,80 @@ error:
 	return MCTP_ERROR;
 }
 
-static uint8_t mctp_pass_tx_task(mctp *mctp_inst, uint8_t *buf, uint16_t len,
-				 mctp_ext_params ext_params, uint8_t is_bridge)
+uint8_t *mctp_tx_buf_alloc(k_timeout_t timeout)
 {
-	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, MCTP_ERROR);
-	CHECK_NULL_ARG_WITH_RETURN(buf, MCTP_ERROR);
-	CHECK_ARG_WITH_RETURN(!len, MCTP_ERROR);
+	uint8_t *buf = NULL;
+
+	if (k_mem_slab_alloc(&mctp_tx_slab, (void **)&buf, timeout))
+		return NULL;
+
+	return buf;
+}
+
+void mctp_tx_buf_free(uint8_t *buf)
+{
+	CHECK_NULL_ARG(buf);
+
+	k_mem_slab_free(&mctp_tx_slab, (void **)&buf);
+}
+
+/* Queue the message to the tx task, the message buffer is released here if it fails */
+static uint8_t mctp_pass_tx_task(mctp *mctp_inst, mctp_tx_msg *mctp_msg)
+{
+	CHECK_NULL_ARG_WITH_RETURN(mctp_msg, MCTP_ERROR);
+
+	if (!mctp_inst || !mctp_msg->buf || !mctp_msg->len)
+		goto error;
 
 	if (!mctp_inst->is_servcie_start) {
 		LOG_WRN("The mctp_inst isn't start service!");
-		return MCTP_ERROR;
+		goto error;
 	}
 
-	mctp_tx_msg mctp_msg = { 0 };
-	mctp_msg.is_bridge_packet = is_bridge;
-	mctp_msg.len = len;
-	mctp_msg.buf = (uint8_t *)malloc(len);
-	if (!mctp_msg.buf)
+	if (k_msgq_put(&mctp_inst->mctp_tx_queue, mctp_msg, K_NO_WAIT)) {
+		LOG_WRN("mctp tx queue full!");
 		goto error;
-	memcpy(mctp_msg.buf, buf, len);
-
-	mctp_msg.ext_params = ext_params;
+	}
 
-	/* create msg queue for catching the return code from mctp_tx_task */
-	uint8_t evt_msgq_buf = 0;
-	struct k_msgq evt_msgq;
+	return MCTP_SUCCESS;
 
-	k_msgq_init(&evt_msgq, &evt_msgq_buf, sizeof(uint8_t), 1);
-	mctp_msg.evt_msgq = &evt_msgq;
+error:
+	/* the caller isn't notified by cb if the message isn't queued */
+	mctp_msg->cb = NULL;
+	mctp_tx_msg_done(mctp_msg, MCTP_ERROR);
+	return MCTP_ERROR;
+}
 
-	int ret = k_msgq_put(&mctp_inst->mctp_tx_queue, &mctp_msg, K_NO_WAIT);
-	if (!ret) {
-		uint8_t evt = MCTP_ERROR;
-		if (k_msgq_get(&evt_msgq, &evt, K_FOREVER))
-			LOG_WRN("failed to get status from msgq!");
+static uint8_t mctp_copy_to_tx_task(mctp *mctp_inst, uint8_t *buf, uint16_t len,
+				    mctp_ext_params ext_params, uint8_t is_bridge, mctp_tx_cb cb,
+				    void *cb_args)
+{
+	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, MCTP_ERROR);
+	CHECK_NULL_ARG_WITH_RETURN(buf, MCTP_ERROR);
+	CHECK_ARG_WITH_RETURN(!len, MCTP_ERROR);
 
-		return evt;
+	mctp_tx_msg mctp_msg = { 0 };
+	mctp_msg.is_bridge_packet = is_bridge;
+	mctp_msg.len = len;
+	mctp_msg.ext_params = ext_params;
+	mctp_msg.cb = cb;
+	mctp_msg.cb_args = cb_args;
+
+	/* fall back to heap if the message is too large or the pool is exhausted */
+	if (len <= MCTP_TX_BUF_SIZE)
+		mctp_msg.buf = mctp_tx_buf_alloc(K_NO_WAIT);
+	if (mctp_msg.buf) {
+		mctp_msg.is_pool_buf = 1;
+	} else {
+		mctp_msg.buf = (uint8_t *)malloc(len);
+		if (!mctp_msg.buf) {
+			LOG_WRN("mctp tx buffer alloc failed!");
+			return MCTP_ERROR;
+		}
 	}
+	memcpy(mctp_msg.buf, buf, len);
 
-error:
-	if (mctp_msg.buf)
-		free(mctp_msg.buf);
-
-	return MCTP_ERROR;
+	return mctp_pass_tx_task(mctp_inst, &mctp_msg);
 }
 
 uint8_t mctp_bridge_msg(mctp *mctp_inst, uint8_t *buf, uint16_t len, mctp_ext_params ext_params)
@@ -577,7 +885,7 @@ uint8_t mctp_bridge_msg(mctp *mctp_inst, uint8_t *buf, uint16_t len, mctp_ext_pa
 	CHECK_NULL_ARG_WITH_RETURN(buf, MCTP_ERROR);
 	CHECK_ARG_WITH_RETURN(!len, MCTP_ERROR);
 
-	return mctp_pass_tx_task(mctp_inst, buf, len, ext_params, 1);
+	return mctp_copy_to_tx_task(mctp_inst, buf, len, ext_params, 1, NULL, NULL);
 }
 
 uint8_t mctp_send_msg(mctp *mctp_inst, uint8_t *buf, uint16_t len, mctp_ext_params ext_params)
@@ -586,7 +894,58 @@ uint8_t mctp_send_msg(mctp *mctp_inst, uint8_t *buf, uint16_t len, mctp_ext_para
 	CHECK_NULL_ARG_WITH_RETURN(buf, MCTP_ERROR);
 	CHECK_ARG_WITH_RETURN(!len, MCTP_ERROR);
 
-	return mctp_pass_tx_task(mctp_inst, buf, len, ext_params, 0);
+	return mctp_copy_to_tx_task(mctp_inst, buf, len, ext_params, 0, NULL, NULL);
+}
+
+typedef struct _mctp_tx_sync {
+	struct k_sem done;
+	uint8_t status;
+} mctp_tx_sync;
+
+static void mctp_send_msg_sync_done(void *args, uint8_t status)
+{
+	CHECK_NULL_ARG(args);
+
+	mctp_tx_sync *sync = (mctp_tx_sync *)args;
+	sync->status = status;
+	k_sem_give(&sync->done);
+}
+
+uint8_t mctp_send_msg_sync(mctp *mctp_inst, uint8_t *buf, uint16_t len,
+			   mctp_ext_params ext_params)
+{
+	CHECK_NULL_ARG_WITH_RETURN(mctp_inst, MCTP_ERROR);
+	CHECK_NULL_ARG_WITH_RETURN(buf, MCTP_ERROR);
+	CHECK_ARG_WITH_RETURN(!len, MCTP_ERROR);
+
+	mctp_tx_sync sync = { .status = MCTP_ERROR };
+	k_sem_init(&sync.done, 0, 1);
+
+	if (mctp_copy_to_tx_task(mctp_inst, buf, len, ext_params, 0, mctp_send_msg_sync_done,
+				 &sync) != MCTP_SUCCESS)
+		return MCTP_ERROR;
+
+	/* a queued message is always called back, by the tx task or by mctp_stop() draining the
+	 * queue with error
+	 */
+	k_sem_take(&sync.done, K_FOREVER);
+	return sync.status;
+}
+
+uint8_t mctp_send_msg_async(mctp *mctp_inst, uint8_t *buf, uint16_t len,
+			    mctp_ext_params ext_params, mctp_tx_cb cb, void *cb_args)
+{
+	CHECK_NULL_ARG_WITH_RETURN(buf, MCTP_ERROR);
+
+	mctp_tx_msg mctp_msg = { 0 };
+	mctp_msg.is_pool_buf = 1;
+	mctp_msg.buf = buf;
+	mctp_msg.len = (len <= MCTP_TX_BUF_SIZE) ? len : 0;
+	mctp_msg.ext_params = ext_params;
+	mctp_msg.cb = cb;
+	mctp_msg.cb_args = cb_args;
+
+	return mctp_pass_tx_task(mctp_inst, &mctp_msg);
 }
 
 uint8_t mctp_reg_endpoint_resolve_func(mctp *mctp_inst, endpoint_resolve resolve_fn)
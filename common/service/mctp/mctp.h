@@ -35,8 +35,38 @@ extern "C" {
 
 #define MCTP_TX_QUEUE_SIZE 16
 
-#define MSG_ASSEMBLY_BUF_SIZE 1024
+/* Pooled tx buffers for mctp_send_msg_async(), shared by all mctp instances */
+#ifndef MCTP_TX_BUF_SIZE
+#define MCTP_TX_BUF_SIZE 1024
+#endif
+#ifndef MCTP_TX_POOL_NUM
+#define MCTP_TX_POOL_NUM 8
+#endif
+
+/* Multi-packet messages are reassembled in MCTP_ASSEMBLY_BUF_SIZE bytes buffers from a pool of
+ * MCTP_ASSEMBLY_POOL_NUM buffers shared by all mctp instances, platform could define both to
+ * override the defaults.
+ */
+#define MCTP_ASSEMBLY_BUF_SIZE_DEFAULT 1024
+#define MCTP_ASSEMBLY_POOL_NUM_DEFAULT 8
+/* messages reassembling at the same time on one mctp instance */
+#define MCTP_ASSEMBLY_NUM 8
+#define MCTP_ASSEMBLY_TIMEOUT_MS 500
+
+/* Completed rx requests are handled by one worker per message type class, shared by all mctp
+ * instances, so the rx task keeps reading the medium while handlers run. Responses are passed to
+ * rx_cb in the rx task itself and must not block there, so a request handler could wait for the
+ * response of a request it sends without blocking its own worker.
+ * Workers and the packet pool are allocated by the first mctp_start(), platforms without mctp
+ * don't pay for them. Platform could define MCTP_DISPATCH_STACK_SIZE and MCTP_PACKET_POOL_NUM to
+ * override the defaults.
+ */
+#define MCTP_DISPATCH_STACK_SIZE_DEFAULT 4096
+#define MCTP_DISPATCH_QUEUE_SIZE 8
+/* single packet messages are queued to workers in buffers from this pool */
+#define MCTP_PACKET_POOL_NUM_DEFAULT 8
 
+/* response callbacks run in the rx task */
 #define MCTP_RX_TASK_STACK_SIZE 4096
 #define MCTP_TX_TASK_STACK_SIZE 2048
 #define MCTP_TASK_NAME_LEN 32
@@ -56,7 +86,8 @@ extern "C" {
 #define MCTP_HDR_SEQ_MASK 0x03
 #define MCTP_HDR_TAG_MASK 0x07
 
-#define MCTP_POLL_TIME_MS 1
+/* delay before the rx task reads again when the medium read fails */
+#define MCTP_RX_RETRY_DELAY_MS 100
 
 typedef enum {
 	MCTP_MSG_TYPE_CTRL = 0x00,
@@ -106,7 +137,7 @@ typedef struct _mctp_ext_params {
 /* ext_params shoule be bypass to mctp_send_msg if need */
 typedef uint8_t (*mctp_fn_cb)(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext_params ext_params);
 
-/* medium write/read function prototype */
+/* medium write/read function prototype, medium_rx blocks until a packet is received */
 typedef uint16_t (*medium_tx)(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext_params ext_params);
 typedef uint16_t (*medium_rx)(void *mctp_p, uint8_t *buf, uint32_t len,
 			      mctp_ext_params *ext_params);
@@ -134,15 +165,31 @@ typedef union {
 	mctp_i3c_conf i3c_conf;
 } mctp_medium_conf;
 
+/* called by the tx task after the message is written or failed, should not block */
+typedef void (*mctp_tx_cb)(void *args, uint8_t status);
+
 /* mctp tx message struct */
 typedef struct __attribute__((aligned(4))) {
 	uint8_t is_bridge_packet;
+	uint8_t is_pool_buf; /* buf is from mctp_tx_buf_alloc(), otherwise from malloc() */
 	uint8_t *buf;
 	uint16_t len;
 	mctp_ext_params ext_params;
-	struct k_msgq *evt_msgq;
+	mctp_tx_cb cb;
+	void *cb_args;
 } mctp_tx_msg;
 
+/* message reassembling, keyed by source endpoint, tag owner and message tag */
+typedef struct _mctp_assembly {
+	uint8_t *buf; /* NULL if the entry is free */
+	uint16_t offset;
+	uint8_t src_ep;
+	uint8_t tag_owner;
+	uint8_t msg_tag;
+	uint8_t next_seq;
+	int64_t deadline;
+} mctp_assembly;
+
 /* mctp main struct */
 typedef struct _mctp {
 	uint8_t is_servcie_start;
@@ -170,20 +217,14 @@ typedef struct _mctp {
 
 	/* write queue */
 	struct k_msgq mctp_tx_queue;
+	/* held by the tx task while a dequeued message is written */
+	struct k_mutex tx_lock;
 
-	/* point to the rx message buffer that is assembling */
-	struct {
-		uint8_t *buf;
-		uint16_t offset;
-	} temp_msg_buf[MCTP_MAX_MSG_TAG_NUM];
+	/* rx messages that are assembling */
+	mctp_assembly assembly[MCTP_ASSEMBLY_NUM];
 
 	/* the callback when recevie mctp data */
 	mctp_fn_cb rx_cb;
-
-	/* for pldm instance id */
-	uint8_t pldm_inst_id;
-	/* for cci_msg_tag */
-	uint8_t cci_msg_tag;
 } mctp;
 
 /* public function */
@@ -204,9 +245,31 @@ uint8_t mctp_start(mctp *mctp_inst);
 /* mctp service stop */
 uint8_t mctp_stop(mctp *mctp_inst);
 
-/* send message to destination endpoint */
+/*
+ * Send message to destination endpoint, buf is copied and sent by the tx task later.
+ * MCTP_SUCCESS only means the message is queued, MCTP_ERROR if it could not be queued, e.g. the
+ * tx queue is full. Use mctp_send_msg_sync() if the caller needs to know the write result.
+ */
 uint8_t mctp_send_msg(mctp *mctp_inst, uint8_t *buf, uint16_t len, mctp_ext_params ext_params);
 
+/* Same as mctp_send_msg() but wait until the tx task has written the message to the medium,
+ * returns MCTP_SUCCESS only if every packet is written. Must not be called from a mctp_tx_cb.
+ */
+uint8_t mctp_send_msg_sync(mctp *mctp_inst, uint8_t *buf, uint16_t len,
+			   mctp_ext_params ext_params);
+
+/* pooled tx buffer of MCTP_TX_BUF_SIZE bytes */
+uint8_t *mctp_tx_buf_alloc(k_timeout_t timeout);
+void mctp_tx_buf_free(uint8_t *buf);
+
+/*
+ * Send the message in buf without copying, buf must be from mctp_tx_buf_alloc() and is owned by
+ * mctp since then, even if it returns MCTP_ERROR. cb is optional and isn't called if it returns
+ * MCTP_ERROR.
+ */
+uint8_t mctp_send_msg_async(mctp *mctp_inst, uint8_t *buf, uint16_t len,
+			    mctp_ext_params ext_params, mctp_tx_cb cb, void *cb_args);
+
 /* bridge message to destination endpoint */
 uint8_t mctp_bridge_msg(mctp *mctp_inst, uint8_t *buf, uint16_t len, mctp_ext_params ext_params);
 
@@ -16,6 +16,7 @@
 
 #include "mctp.h"
 #include "mctp_ctrl.h"
+#include "mctp_pending.h"
 #include <logging/log.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -27,21 +28,29 @@
 LOG_MODULE_DECLARE(mctp);
 
 #define DEFAULT_WAIT_TO_MS 3000
-#define RESP_MSG_PROC_MUTEX_WAIT_TO_MS 1000
-#define TO_CHK_INTERVAL_MS 1000
 
-#define MCTP_CTRL_INST_ID_MASK 0x3F
+/* instance ids in use at the same time, the header has room for 32 */
+#define MCTP_CTRL_INST_ID_NUM 8
 
-typedef struct _wait_msg {
-	sys_snode_t node;
-	mctp *mctp_inst;
-	int64_t exp_to_ms;
-	mctp_ctrl_msg msg;
-} wait_msg;
+static void mctp_ctrl_pending_resp(void *msg, uint8_t *buf, uint16_t len)
+{
+	mctp_ctrl_msg *p = (mctp_ctrl_msg *)msg;
+
+	if (p->recv_resp_cb_fn)
+		p->recv_resp_cb_fn(p->recv_resp_cb_args, buf + sizeof(p->hdr),
+				   len - sizeof(p->hdr)); /* remove mctp ctrl header for handler */
+}
 
-static K_MUTEX_DEFINE(wait_recv_resp_mutex);
+static void mctp_ctrl_pending_timeout(void *msg)
+{
+	mctp_ctrl_msg *p = (mctp_ctrl_msg *)msg;
+
+	if (p->timeout_cb_fn)
+		p->timeout_cb_fn(p->timeout_cb_fn_args);
+}
 
-static sys_slist_t wait_recv_resp_list = SYS_SLIST_STATIC_INIT(&wait_recv_resp_list);
+MCTP_PENDING_TABLE_DEFINE(mctp_ctrl_pending, MCTP_CTRL_INST_ID_NUM, mctp_ctrl_msg,
+			  mctp_ctrl_pending_resp, mctp_ctrl_pending_timeout);
 
 uint8_t mctp_ctrl_cmd_get_endpoint_id(void *mctp_inst, uint8_t *buf, uint16_t len, uint8_t *resp,
 				      uint16_t *resp_len, void *ext_params)
@@ -64,95 +73,16 @@ uint8_t mctp_ctrl_cmd_get_endpoint_id(void *mctp_inst, uint8_t *buf, uint16_t le
 	return MCTP_SUCCESS;
 }
 
-static uint8_t mctp_ctrl_msg_timeout_check(sys_slist_t *list, struct k_mutex *mutex)
-{
-	if (!list || !mutex)
-		return MCTP_ERROR;
-
-	if (k_mutex_lock(mutex, K_MSEC(RESP_MSG_PROC_MUTEX_WAIT_TO_MS))) {
-		LOG_WRN("pldm mutex is locked over %d ms!!", RESP_MSG_PROC_MUTEX_WAIT_TO_MS);
-		return MCTP_ERROR;
-	}
-
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	int64_t cur_uptime = k_uptime_get();
-
-	SYS_SLIST_FOR_EACH_NODE_SAFE (list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-
-		if ((p->exp_to_ms <= cur_uptime)) {
-			printk("mctp ctrl msg timeout!!\n");
-			printk("cmd %x, inst_id %x\n", p->msg.hdr.cmd, p->msg.hdr.inst_id);
-			sys_slist_remove(list, pre_node, node);
-
-			if (p->msg.timeout_cb_fn)
-				p->msg.timeout_cb_fn(p->msg.timeout_cb_fn_args);
-
-			free(p);
-		} else {
-			pre_node = node;
-		}
-	}
-
-	k_mutex_unlock(mutex);
-	return MCTP_SUCCESS;
-}
-
-static void mctp_ctrl_msg_timeout_monitor(void *dummy0, void *dummy1, void *dummy2)
-{
-	ARG_UNUSED(dummy0);
-	ARG_UNUSED(dummy1);
-	ARG_UNUSED(dummy2);
-
-	while (1) {
-		k_msleep(TO_CHK_INTERVAL_MS);
-
-		mctp_ctrl_msg_timeout_check(&wait_recv_resp_list, &wait_recv_resp_mutex);
-	}
-}
-
 static uint8_t mctp_ctrl_cmd_resp_process(mctp *mctp_inst, uint8_t *buf, uint32_t len,
 					  mctp_ext_params ext_params)
 {
-	if (!mctp_inst || !buf || !len)
-		return MCTP_ERROR;
-
-	if (k_mutex_lock(&wait_recv_resp_mutex, K_MSEC(RESP_MSG_PROC_MUTEX_WAIT_TO_MS))) {
-		LOG_WRN("mutex is locked over %d ms!", RESP_MSG_PROC_MUTEX_WAIT_TO_MS);
+	if (!mctp_inst || !buf || (len < sizeof(mctp_ctrl_hdr)))
 		return MCTP_ERROR;
-	}
 
 	mctp_ctrl_hdr *hdr = (mctp_ctrl_hdr *)buf;
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	sys_snode_t *found_node = NULL;
-
-	SYS_SLIST_FOR_EACH_NODE_SAFE (&wait_recv_resp_list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-		/* found the proper handler */
-		if ((p->msg.hdr.inst_id == hdr->inst_id) && (p->mctp_inst == mctp_inst) &&
-		    (p->msg.hdr.cmd == hdr->cmd)) {
-			found_node = node;
-			sys_slist_remove(&wait_recv_resp_list, pre_node, node);
-			break;
-		} else {
-			pre_node = node;
-		}
-	}
-	k_mutex_unlock(&wait_recv_resp_mutex);
-
-	if (found_node) {
-		/* invoke resp handler */
-		wait_msg *p = (wait_msg *)found_node;
-		if (p->msg.recv_resp_cb_fn)
-			p->msg.recv_resp_cb_fn(
-				p->msg.recv_resp_cb_args, buf + sizeof(p->msg.hdr),
-				len - sizeof(p->msg.hdr)); /* remove mctp ctrl header for handler */
-		free(p);
-	}
+
+	mctp_pending_resp(&mctp_ctrl_pending, hdr->inst_id, mctp_inst, ext_params.ep, hdr->cmd,
+			  buf, len);
 
 	return MCTP_SUCCESS;
 }
@@ -232,13 +162,20 @@ uint8_t mctp_ctrl_send_msg(void *mctp_p, mctp_ctrl_msg *msg)
 
 	mctp *mctp_inst = (mctp *)mctp_p;
 
+	int inst_id = -1;
 	if (msg->hdr.rq) {
-		static uint8_t inst_id;
+		inst_id = mctp_pending_alloc(&mctp_ctrl_pending);
+		if (inst_id < 0)
+			return MCTP_ERROR;
 
-		msg->hdr.inst_id = (inst_id++) & MCTP_CTRL_INST_ID_MASK;
+		msg->hdr.inst_id = inst_id;
 		msg->hdr.msg_type = MCTP_MSG_TYPE_CTRL;
 
 		msg->ext_params.tag_owner = 1;
+
+		mctp_pending_start(&mctp_ctrl_pending, inst_id, mctp_inst, msg->ext_params.ep,
+				   msg->hdr.cmd, msg,
+				   msg->timeout_ms ? msg->timeout_ms : DEFAULT_WAIT_TO_MS);
 	}
 
 	uint16_t len = sizeof(msg->hdr) + msg->cmd_data_len;
@@ -249,31 +186,14 @@ uint8_t mctp_ctrl_send_msg(void *mctp_p, mctp_ctrl_msg *msg)
 
 	LOG_HEXDUMP_DBG(buf, len, __func__);
 
-	uint8_t rc = mctp_send_msg(mctp_inst, buf, len, msg->ext_params);
+	uint8_t rc = (inst_id >= 0) ? mctp_send_msg_sync(mctp_inst, buf, len, msg->ext_params) :
+				    mctp_send_msg(mctp_inst, buf, len, msg->ext_params);
 	if (rc == MCTP_ERROR) {
 		LOG_WRN("mctp_send_msg error!!");
+		if (inst_id >= 0)
+			mctp_pending_cancel(&mctp_ctrl_pending, inst_id, msg);
 		return MCTP_ERROR;
 	}
 
-	if (msg->hdr.rq) {
-		wait_msg *p = (wait_msg *)malloc(sizeof(*p));
-		if (!p) {
-			LOG_WRN("wait_msg alloc failed!");
-			return MCTP_ERROR;
-		}
-
-		memset(p, 0, sizeof(*p));
-		p->mctp_inst = mctp_inst;
-		p->msg = *msg;
-		p->exp_to_ms =
-			k_uptime_get() + (msg->timeout_ms ? msg->timeout_ms : DEFAULT_WAIT_TO_MS);
-
-		k_mutex_lock(&wait_recv_resp_mutex, K_FOREVER);
-		sys_slist_append(&wait_recv_resp_list, &p->node);
-		k_mutex_unlock(&wait_recv_resp_mutex);
-	}
-
 	return MCTP_SUCCESS;
 }
-
-K_THREAD_DEFINE(monitor_tid, 1024, mctp_ctrl_msg_timeout_monitor, NULL, NULL, NULL, 0, 0, 0);
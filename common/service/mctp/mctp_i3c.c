@@ -30,6 +30,11 @@ LOG_MODULE_REGISTER(mctp_i3c);
 #define MCTP_I3C_PEC_ENABLE 0
 #endif
 
+/* The SMQ driver has no rx callback to wake the reader, so the target message queue is polled */
+#ifndef MCTP_I3C_POLL_TIME_MS
+#define MCTP_I3C_POLL_TIME_MS 1
+#endif
+
 static uint16_t mctp_i3c_read_smq(void *mctp_p, uint8_t *buf, uint32_t len,
 				  mctp_ext_params *extra_data)
 {
@@ -41,10 +46,14 @@ static uint16_t mctp_i3c_read_smq(void *mctp_p, uint8_t *buf, uint32_t len,
 	I3C_MSG i3c_msg;
 	mctp *mctp_inst = (mctp *)mctp_p;
 	i3c_msg.bus = mctp_inst->medium_conf.i3c_conf.bus;
-	ret = i3c_smq_read(&i3c_msg);
 
-	/** mctp rx keep polling, return length 0 directly if no data or invalid data **/
+	/** block until the target message queue has data, return length 0 if invalid data **/
+	while ((ret = i3c_smq_read(&i3c_msg)) == -ENODATA) {
+		k_msleep(MCTP_I3C_POLL_TIME_MS);
+	}
+
 	if (ret <= 0) {
+		k_msleep(MCTP_RX_RETRY_DELAY_MS);
 		return 0;
 	}
 
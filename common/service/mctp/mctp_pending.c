@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mctp_pending.h"
+#include "mctp.h"
+#include <logging/log.h>
+#include <string.h>
+#include <zephyr.h>
+#include "libutil.h"
+
+LOG_MODULE_DECLARE(mctp);
+
+#ifndef MCTP_PENDING_STACK_SIZE
+#define MCTP_PENDING_STACK_SIZE MCTP_PENDING_STACK_SIZE_DEFAULT
+#endif
+
+static struct k_work_q pending_work_q;
+static K_THREAD_STACK_DEFINE(pending_work_stack, MCTP_PENDING_STACK_SIZE);
+static bool is_work_q_start;
+
+/* tables are listed when they allocate the first id */
+static mctp_pending_table *table_list;
+static struct k_spinlock table_list_lock;
+
+static void *get_pending_msg(mctp_pending_table *table, uint8_t id)
+{
+	return table->msgs + (id * table->msg_size);
+}
+
+static void release_pending_slot(mctp_pending_table *table, mctp_pending_slot *slot)
+{
+	k_spinlock_key_t lock_key = k_spin_lock(&table->lock);
+	slot->state = MCTP_PENDING_FREE;
+	bool is_cancel_wait = slot->is_cancel_wait;
+	slot->is_cancel_wait = false;
+	k_spin_unlock(&table->lock, lock_key);
+
+	if (is_cancel_wait)
+		k_sem_give(&slot->cancel_sem);
+}
+
+static void pending_timeout_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	mctp_pending_slot *slot = CONTAINER_OF(dwork, mctp_pending_slot, timeout_work);
+	mctp_pending_table *table = slot->table;
+	uint8_t id = slot - table->slots;
+
+	k_spinlock_key_t lock_key = k_spin_lock(&table->lock);
+	/* the response came after the timer expired */
+	if (slot->state != MCTP_PENDING_WAIT_RESP) {
+		k_spin_unlock(&table->lock, lock_key);
+		return;
+	}
+	slot->state = MCTP_PENDING_BUSY;
+	table->stat.timeout++;
+	k_spin_unlock(&table->lock, lock_key);
+
+	LOG_WRN("%s msg timeout, id %d, key 0x%x", table->name, id, slot->key);
+	if (table->timeout_fn)
+		table->timeout_fn(get_pending_msg(table, id));
+
+	release_pending_slot(table, slot);
+}
+
+int mctp_pending_alloc(mctp_pending_table *table)
+{
+	CHECK_NULL_ARG_WITH_RETURN(table, -1);
+
+	int id = -1;
+	k_spinlock_key_t lock_key = k_spin_lock(&table->lock);
+
+	if (!table->is_init) {
+		for (uint16_t i = 0; i < table->id_num; i++) {
+			k_work_init_delayable(&table->slots[i].timeout_work,
+					      pending_timeout_handler);
+			k_sem_init(&table->slots[i].cancel_sem, 0, 1);
+			table->slots[i].table = table;
+		}
+		table->is_init = true;
+
+		k_spinlock_key_t list_key = k_spin_lock(&table_list_lock);
+		table->next = table_list;
+		table_list = table;
+		k_spin_unlock(&table_list_lock, list_key);
+	}
+
+	/* ids are handed out in turn, so the next one is free unless the peer stops responding */
+	for (uint16_t i = 0; i < table->id_num; i++) {
+		uint16_t next = (table->next_id + i) % table->id_num;
+		if (table->slots[next].state == MCTP_PENDING_FREE) {
+			table->slots[next].state = MCTP_PENDING_RESERVED;
+			table->next_id = (next + 1) % table->id_num;
+			id = next;
+			break;
+		}
+	}
+
+	if (id < 0)
+		table->stat.no_slot++;
+	k_spin_unlock(&table->lock, lock_key);
+
+	if (id < 0)
+		LOG_WRN("%s all %d ids are pending", table->name, table->id_num);
+
+	return id;
+}
+
+void mctp_pending_start(mctp_pending_table *table, uint8_t id, void *mctp_inst, uint8_t ep,
+			uint16_t key, void *msg, uint32_t timeout_ms)
+{
+	CHECK_NULL_ARG(table);
+	CHECK_NULL_ARG(msg);
+
+	if (id >= table->id_num)
+		return;
+
+	mctp_pending_slot *slot = &table->slots[id];
+	k_spinlock_key_t lock_key = k_spin_lock(&table->lock);
+
+	if (slot->state != MCTP_PENDING_RESERVED) {
+		k_spin_unlock(&table->lock, lock_key);
+		LOG_WRN("%s id %d isn't reserved", table->name, id);
+		return;
+	}
+
+	memcpy(get_pending_msg(table, id), msg, table->msg_size);
+	slot->mctp_inst = mctp_inst;
+	slot->ep = ep;
+	slot->key = key;
+	slot->send_ms = k_uptime_get();
+	slot->state = MCTP_PENDING_WAIT_RESP;
+	table->stat.sent++;
+
+	k_spin_unlock(&table->lock, lock_key);
+
+	/* nothing else touches the slot until the request is sent */
+	k_work_reschedule_for_queue(&pending_work_q, &slot->timeout_work, K_MSEC(timeout_ms));
+}
+
+bool mctp_pending_cancel(mctp_pending_table *table, uint8_t id, void *msg)
+{
+	CHECK_NULL_ARG_WITH_RETURN(table, false);
+	CHECK_NULL_ARG_WITH_RETURN(msg, false);
+
+	if (id >= table->id_num)
+		return false;
+
+	mctp_pending_slot *slot = &table->slots[id];
+	k_spinlock_key_t lock_key = k_spin_lock(&table->lock);
+
+	/* the id may have been released and handed to another requester since it was sent */
+	if ((slot->state == MCTP_PENDING_FREE) ||
+	    memcmp(get_pending_msg(table, id), msg, table->msg_size)) {
+		k_spin_unlock(&table->lock, lock_key);
+		return false;
+	}
+
+	/* the request is completing, wait until its callback returns */
+	if (slot->state == MCTP_PENDING_BUSY) {
+		slot->is_cancel_wait = true;
+		k_spin_unlock(&table->lock, lock_key);
+		k_sem_take(&slot->cancel_sem, K_FOREVER);
+		return false;
+	}
+
+	slot->state = MCTP_PENDING_BUSY;
+	k_spin_unlock(&table->lock, lock_key);
+
+	struct k_work_sync sync;
+	k_work_cancel_delayable_sync(&slot->timeout_work, &sync);
+	release_pending_slot(table, slot);
+	return true;
+}
+
+bool mctp_pending_resp(mctp_pending_table *table, uint8_t id, void *mctp_inst, uint8_t ep,
+		       uint16_t key, uint8_t *buf, uint16_t len)
+{
+	CHECK_NULL_ARG_WITH_RETURN(table, false);
+	CHECK_NULL_ARG_WITH_RETURN(buf, false);
+
+	mctp_pending_slot *slot = (id < table->id_num) ? &table->slots[id] : NULL;
+	k_spinlock_key_t lock_key = k_spin_lock(&table->lock);
+
+	/* endpoint is only compared if both the request and the response carry one */
+	bool is_ep_match = (slot && ((slot->ep == MCTP_NULL_EID) || (ep == MCTP_NULL_EID) ||
+				     (slot->ep == ep)));
+	if (!is_ep_match || (slot->state != MCTP_PENDING_WAIT_RESP) ||
+	    (slot->mctp_inst != mctp_inst) || (slot->key != key)) {
+		table->stat.unexpected++;
+		k_spin_unlock(&table->lock, lock_key);
+		LOG_DBG("%s no pending request for id %d, key 0x%x", table->name, id, key);
+		return false;
+	}
+
+	slot->state = MCTP_PENDING_BUSY;
+
+	uint32_t latency_ms = (uint32_t)(k_uptime_get() - slot->send_ms);
+	table->stat.resp++;
+	table->stat.total_latency_ms += latency_ms;
+	if (latency_ms > table->stat.max_latency_ms)
+		table->stat.max_latency_ms = latency_ms;
+
+	k_spin_unlock(&table->lock, lock_key);
+
+	/* a timeout handler already running sees the busy state and returns */
+	struct k_work_sync sync;
+	k_work_cancel_delayable_sync(&slot->timeout_work, &sync);
+
+	if (table->resp_fn)
+		table->resp_fn(get_pending_msg(table, id), buf, len);
+
+	release_pending_slot(table, slot);
+	return true;
+}
+
+bool mctp_pending_get_stat(uint8_t index, mctp_pending_stat *stat)
+{
+	CHECK_NULL_ARG_WITH_RETURN(stat, false);
+
+	k_spinlock_key_t list_key = k_spin_lock(&table_list_lock);
+	mctp_pending_table *table = table_list;
+	for (uint8_t i = 0; table && (i < index); i++)
+		table = table->next;
+	k_spin_unlock(&table_list_lock, list_key);
+
+	if (!table)
+		return false;
+
+	k_spinlock_key_t lock_key = k_spin_lock(&table->lock);
+	*stat = table->stat;
+	k_spin_unlock(&table->lock, lock_key);
+
+	stat->name = table->name;
+	return true;
+}
+
+void mctp_pending_init(void)
+{
+	if (is_work_q_start)
+		return;
+
+	k_work_queue_start(&pending_work_q, pending_work_stack,
+			   K_THREAD_STACK_SIZEOF(pending_work_stack), K_PRIO_PREEMPT(1), NULL);
+	k_thread_name_set(&pending_work_q.thread, "mctp_pending");
+	is_work_q_start = true;
+}
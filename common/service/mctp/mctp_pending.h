@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _MCTP_PENDING_H
+#define _MCTP_PENDING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr.h>
+
+/*
+ * Requests waiting for a response, shared by PLDM, MCTP control and CCI requesters.
+ * The table allocates the instance id / tag of each request, so a response is matched to its
+ * slot by id directly. Each slot expires by its own delayable work on the mctp_pending workqueue,
+ * so timeout_fn should only notify the requester and return.
+ */
+
+#define MCTP_PENDING_STACK_SIZE_DEFAULT 1024
+
+typedef enum {
+	MCTP_PENDING_FREE = 0,
+	MCTP_PENDING_RESERVED, /* id allocated, request not sent yet */
+	MCTP_PENDING_WAIT_RESP,
+	MCTP_PENDING_BUSY, /* response or timeout callback is running */
+} MCTP_PENDING_STATE;
+
+typedef struct _mctp_pending_stat {
+	const char *name;
+	uint32_t sent;
+	uint32_t resp;
+	uint32_t timeout;
+	uint32_t no_slot; /* all ids are pending */
+	uint32_t unexpected; /* response without pending request */
+	uint32_t max_latency_ms;
+	uint32_t total_latency_ms; /* of all responses, average is total_latency_ms / resp */
+} mctp_pending_stat;
+
+typedef struct _mctp_pending_slot {
+	struct k_work_delayable timeout_work;
+	struct _mctp_pending_table *table;
+	MCTP_PENDING_STATE state;
+	void *mctp_inst;
+	uint8_t ep;
+	uint16_t key; /* protocol specific, e.g. command code */
+	int64_t send_ms;
+	struct k_sem cancel_sem; /* given when the callback returns while cancel waits */
+	bool is_cancel_wait;
+} mctp_pending_slot;
+
+typedef struct _mctp_pending_table {
+	const char *name;
+	uint16_t id_num; /* ids are 0 ~ id_num - 1 */
+	uint16_t msg_size;
+	uint8_t *msgs; /* copy of each pending request, id_num * msg_size bytes */
+	mctp_pending_slot *slots;
+	/* buf is the whole response message including the protocol header */
+	void (*resp_fn)(void *msg, uint8_t *buf, uint16_t len);
+	void (*timeout_fn)(void *msg);
+
+	struct k_spinlock lock;
+	bool is_init;
+	struct _mctp_pending_table *next;
+	uint16_t next_id;
+	mctp_pending_stat stat;
+} mctp_pending_table;
+
+#define MCTP_PENDING_TABLE_DEFINE(_name, _id_num, _msg_type, _resp_fn, _timeout_fn)                \
+	static mctp_pending_slot _name##_slots[_id_num];                                           \
+	static _msg_type _name##_msgs[_id_num];                                                    \
+	static mctp_pending_table _name = {                                                        \
+		.name = #_name,                                                                    \
+		.id_num = _id_num,                                                                 \
+		.msg_size = sizeof(_msg_type),                                                     \
+		.msgs = (uint8_t *)_name##_msgs,                                                   \
+		.slots = _name##_slots,                                                            \
+		.resp_fn = _resp_fn,                                                               \
+		.timeout_fn = _timeout_fn,                                                         \
+	}
+
+/* return the allocated id, or -1 if all ids are pending */
+int mctp_pending_alloc(mctp_pending_table *table);
+/* store the request and start its timer, should be called before the request is sent */
+void mctp_pending_start(mctp_pending_table *table, uint8_t id, void *mctp_inst, uint8_t ep,
+			uint16_t key, void *msg, uint32_t timeout_ms);
+/* release the id without callback, e.g. the request failed to send or the requester stops waiting.
+ * msg is the request passed to mctp_pending_start(), nothing is done if the id has been reused.
+ * If the callback is running, wait for it and return false. Must not be called from the callbacks.
+ */
+bool mctp_pending_cancel(mctp_pending_table *table, uint8_t id, void *msg);
+/* invoke resp_fn of the matched request, return false if nothing is pending on the id */
+bool mctp_pending_resp(mctp_pending_table *table, uint8_t id, void *mctp_inst, uint8_t ep,
+		       uint16_t key, uint8_t *buf, uint16_t len);
+/* stat of the index-th table in use, return false if there's no such table */
+bool mctp_pending_get_stat(uint8_t index, mctp_pending_stat *stat);
+/* start the timeout workqueue, called by mctp_start() */
+void mctp_pending_init(void);
+
+#endif /* _MCTP_PENDING_H */
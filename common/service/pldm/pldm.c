@@ -16,6 +16,7 @@
 
 #include "pldm.h"
 #include "mctp.h"
+#include "mctp_pending.h"
 #include <logging/log.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -25,26 +26,20 @@
 #include <zephyr.h>
 #include "libutil.h"
 #include "ipmi.h"
+#include "hal_i2c.h"
 
 LOG_MODULE_REGISTER(pldm);
 
-#define PLDM_HDR_INST_ID_MASK 0x1F
-#define PLDM_MSG_CHECK_PER_MS 1000
+BUILD_ASSERT(PLDM_MAX_DATA_SIZE <= MCTP_TX_BUF_SIZE, "pldm response is built in mctp tx buffer");
+
+#define PLDM_INST_ID_NUM 32
 #define PLDM_MSG_TIMEOUT_MS 5000
-#define PLDM_RESP_MSG_PROC_MUTEX_TIMEOUT_MS 500
 #define PLDM_TASK_NAME_MAX_SIZE 32
 #define PLDM_MSG_MAX_RETRY 3
 
 #define PLDM_READ_EVENT_SUCCESS BIT(0)
 #define PLDM_READ_EVENT_TIMEOUT BIT(1)
 
-typedef struct _wait_msg {
-	sys_snode_t node;
-	mctp *mctp_inst;
-	int64_t exp_to_ms;
-	pldm_msg msg;
-} wait_msg;
-
 struct _pldm_handler_query_entry {
 	PLDM_TYPE type;
 	uint8_t (*handler_query)(uint8_t, void **);
@@ -64,9 +59,29 @@ static struct _pldm_handler_query_entry query_tbl[] = {
 	{ PLDM_TYPE_OEM, pldm_oem_handler_query },
 };
 
-static K_MUTEX_DEFINE(wait_recv_resp_mutex);
+/* match a response by pldm type and command besides the instance id */
+#define PLDM_PENDING_KEY(pldm_type, cmd) (((pldm_type) << 8) | (cmd))
+
+static void pldm_pending_resp(void *msg, uint8_t *buf, uint16_t len)
+{
+	pldm_msg *p = (pldm_msg *)msg;
 
-static sys_slist_t wait_recv_resp_list = SYS_SLIST_STATIC_INIT(&wait_recv_resp_list);
+	if (p->recv_resp_cb_fn)
+		/* remove pldm header for handler */
+		p->recv_resp_cb_fn(p->recv_resp_cb_args, buf + sizeof(p->hdr),
+				   len - sizeof(p->hdr));
+}
+
+static void pldm_pending_timeout(void *msg)
+{
+	pldm_msg *p = (pldm_msg *)msg;
+
+	if (p->timeout_cb_fn)
+		p->timeout_cb_fn(p->timeout_cb_fn_args);
+}
+
+MCTP_PENDING_TABLE_DEFINE(pldm_pending, PLDM_INST_ID_NUM, pldm_msg, pldm_pending_resp,
+			  pldm_pending_timeout);
 
 void pldm_read_resp_handler(void *args, uint8_t *rbuf, uint16_t rlen)
 {
@@ -128,6 +143,9 @@ uint16_t mctp_pldm_read(void *mctp_p, pldm_msg *msg, uint8_t *rbuf, uint16_t rbu
 		}
 		if (k_msgq_get(&event_msgq, &event, K_MSEC(PLDM_MSG_TIMEOUT_MS + 1000))) {
 			LOG_WRN("Failed to get status from msgq!");
+			/* recv_arg and event_msgq are on this stack, no callback may run after return */
+			mctp_pending_cancel(&pldm_pending, msg->hdr.inst_id, msg);
+			k_msgq_purge(&event_msgq);
 			continue;
 		}
 		if (event == PLDM_READ_EVENT_SUCCESS) {
@@ -138,97 +156,16 @@ uint16_t mctp_pldm_read(void *mctp_p, pldm_msg *msg, uint8_t *rbuf, uint16_t rbu
 	return 0;
 }
 
-static uint8_t pldm_msg_timeout_check(sys_slist_t *list, struct k_mutex *mutex)
-{
-	if (!list || !mutex)
-		return MCTP_ERROR;
-
-	if (k_mutex_lock(mutex, K_MSEC(PLDM_RESP_MSG_PROC_MUTEX_TIMEOUT_MS))) {
-		LOG_WRN("pldm mutex is locked over %d ms!!", PLDM_RESP_MSG_PROC_MUTEX_TIMEOUT_MS);
-		return MCTP_ERROR;
-	}
-
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	int64_t cur_uptime = k_uptime_get();
-
-	SYS_SLIST_FOR_EACH_NODE_SAFE (list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-
-		if ((p->exp_to_ms <= cur_uptime)) {
-			printk("pldm msg timeout!!\n");
-			printk("cmd %x, inst_id %x\n", p->msg.hdr.cmd, p->msg.hdr.inst_id);
-			sys_slist_remove(list, pre_node, node);
-
-			if (p->msg.timeout_cb_fn)
-				p->msg.timeout_cb_fn(p->msg.timeout_cb_fn_args);
-
-			free(p);
-		} else {
-			pre_node = node;
-		}
-	}
-
-	k_mutex_unlock(mutex);
-	return MCTP_SUCCESS;
-}
-
-static void pldm_msg_timeout_monitor(void *dummy0, void *dummy1, void *dummy2)
-{
-	ARG_UNUSED(dummy0);
-	ARG_UNUSED(dummy1);
-	ARG_UNUSED(dummy2);
-
-	while (1) {
-		k_msleep(PLDM_MSG_CHECK_PER_MS);
-
-		pldm_msg_timeout_check(&wait_recv_resp_list, &wait_recv_resp_mutex);
-	}
-}
-
 static uint8_t pldm_resp_msg_process(mctp *mctp_inst, uint8_t *buf, uint32_t len,
 				     mctp_ext_params ext_params)
 {
-	if (!mctp_inst || !buf || !len)
+	if (!mctp_inst || !buf || (len < sizeof(pldm_hdr)))
 		return PLDM_ERROR;
 
 	pldm_hdr *hdr = (pldm_hdr *)buf;
-	sys_snode_t *node;
-	sys_snode_t *s_node;
-	sys_snode_t *pre_node = NULL;
-	sys_snode_t *found_node = NULL;
-
-	if (k_mutex_lock(&wait_recv_resp_mutex, K_MSEC(PLDM_RESP_MSG_PROC_MUTEX_TIMEOUT_MS))) {
-		LOG_WRN("pldm mutex is locked over %d ms!!", PLDM_RESP_MSG_PROC_MUTEX_TIMEOUT_MS);
-		return PLDM_ERROR;
-	}
 
-	SYS_SLIST_FOR_EACH_NODE_SAFE (&wait_recv_resp_list, node, s_node) {
-		wait_msg *p = (wait_msg *)node;
-
-		/* found the proper handler */
-		if ((p->msg.hdr.inst_id == hdr->inst_id) &&
-		    (p->msg.hdr.pldm_type == hdr->pldm_type) && (p->msg.hdr.cmd == hdr->cmd) &&
-		    (p->mctp_inst == mctp_inst)) {
-			found_node = node;
-			sys_slist_remove(&wait_recv_resp_list, pre_node, node);
-			break;
-		} else {
-			pre_node = node;
-		}
-	}
-	k_mutex_unlock(&wait_recv_resp_mutex);
-
-	if (found_node) {
-		/* invoke resp handler */
-		wait_msg *p = (wait_msg *)found_node;
-		if (p->msg.recv_resp_cb_fn)
-			/* remove pldm header for handler */
-			p->msg.recv_resp_cb_fn(p->msg.recv_resp_cb_args, buf + sizeof(p->msg.hdr),
-					       len - sizeof(p->msg.hdr));
-		free(p);
-	}
+	mctp_pending_resp(&pldm_pending, hdr->inst_id, mctp_inst, ext_params.ep,
+			  PLDM_PENDING_KEY(hdr->pldm_type, hdr->cmd), buf, len);
 
 	return PLDM_SUCCESS;
 }
@@ -255,8 +192,13 @@ uint8_t mctp_pldm_cmd_handler(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext
 
 	/* the message is a request, find the proper handler to handle it */
 
-	/* initial response data */
-	uint8_t resp_buf[PLDM_MAX_DATA_SIZE] = { 0 };
+	/* initial response data, the pooled buffer is handed to mctp without copying */
+	uint8_t *resp_buf = mctp_tx_buf_alloc(K_MSEC(PLDM_RESP_BUF_ALLOC_TIMEOUT_MS));
+	if (!resp_buf) {
+		LOG_WRN("Drop pldm request, no response buffer");
+		return PLDM_ERROR;
+	}
+	memset(resp_buf, 0, PLDM_MAX_DATA_SIZE);
 	/*
 * Default without header length, the header length will be added before
 * sending.
@@ -294,15 +236,23 @@ uint8_t mctp_pldm_cmd_handler(void *mctp_p, uint8_t *buf, uint32_t len, mctp_ext
 		goto send_msg;
 	}
 
+	// Bus access done for the requester goes ahead of sensor polling
+	bool is_i2c_priority = (i2c_priority_enter() == 0);
+	if (!is_i2c_priority)
+		LOG_WRN("No I2C priority for pldm type 0x%x cmd 0x%x", hdr->pldm_type, hdr->cmd);
 	rc = handler(mctp_inst, buf + sizeof(*hdr), len - sizeof(*hdr), (hdr->req_d_id) & 0x1F,
 		     resp_buf + sizeof(*hdr), &resp_len, &ext_params);
-	if (rc == PLDM_LATER_RESP)
+	if (is_i2c_priority)
+		i2c_priority_exit();
+	if (rc == PLDM_LATER_RESP) {
+		mctp_tx_buf_free(resp_buf);
 		return PLDM_SUCCESS;
+	}
 
 send_msg:
 	/* send the pldm response data */
 	resp_len = sizeof(*hdr) + resp_len;
-	return mctp_send_msg(mctp_inst, resp_buf, resp_len, ext_params);
+	return mctp_send_msg_async(mctp_inst, resp_buf, resp_len, ext_params, NULL, NULL);
 }
 
 uint8_t mctp_pldm_send_msg(void *mctp_p, pldm_msg *msg)
@@ -316,13 +266,23 @@ uint8_t mctp_pldm_send_msg(void *mctp_p, pldm_msg *msg)
 * The request should be set inst_id/msg_type/mctp_tag_owner in the
 * header
 */
+	int inst_id = -1;
 	if (msg->hdr.rq) {
+		inst_id = mctp_pending_alloc(&pldm_pending);
+		if (inst_id < 0)
+			return PLDM_ERROR;
+
 		/* set pldm header */
-		msg->hdr.inst_id = (mctp_inst->pldm_inst_id++) & PLDM_HDR_INST_ID_MASK;
+		msg->hdr.inst_id = inst_id;
 		msg->hdr.msg_type = MCTP_MSG_TYPE_PLDM;
 
 		/* set mctp extra parameters */
 		msg->ext_params.tag_owner = 1;
+
+		/* wait for the response before sending, it could come back at once */
+		mctp_pending_start(&pldm_pending, inst_id, mctp_inst, msg->ext_params.ep,
+				   PLDM_PENDING_KEY(msg->hdr.pldm_type, msg->hdr.cmd), msg,
+				   msg->timeout_ms ? msg->timeout_ms : PLDM_MSG_TIMEOUT_MS);
 	}
 
 	uint16_t len = sizeof(msg->hdr) + msg->len;
@@ -333,31 +293,17 @@ uint8_t mctp_pldm_send_msg(void *mctp_p, pldm_msg *msg)
 	memcpy(buf, &msg->hdr, sizeof(msg->hdr));
 	memcpy(buf + sizeof(msg->hdr), msg->buf, msg->len);
 
-	uint8_t rc = mctp_send_msg(mctp_inst, buf, len, msg->ext_params);
+	/* requests wait for the write, so a failed write is reported to the caller to retry */
+	uint8_t rc = (inst_id >= 0) ? mctp_send_msg_sync(mctp_inst, buf, len, msg->ext_params) :
+				    mctp_send_msg(mctp_inst, buf, len, msg->ext_params);
 
 	if (rc == MCTP_ERROR) {
 		LOG_WRN("mctp_send_msg error!!");
+		if (inst_id >= 0)
+			mctp_pending_cancel(&pldm_pending, inst_id, msg);
 		return PLDM_ERROR;
 	}
 
-	if (msg->hdr.rq) {
-		wait_msg *p = (wait_msg *)malloc(sizeof(*p));
-		if (!p) {
-			LOG_WRN("wait_msg alloc failed!");
-			return MCTP_ERROR;
-		}
-
-		memset(p, 0, sizeof(*p));
-		p->mctp_inst = mctp_inst;
-		p->msg = *msg;
-		p->exp_to_ms =
-			k_uptime_get() + (msg->timeout_ms ? msg->timeout_ms : PLDM_MSG_TIMEOUT_MS);
-
-		k_mutex_lock(&wait_recv_resp_mutex, K_FOREVER);
-		sys_slist_append(&wait_recv_resp_list, &p->node);
-		k_mutex_unlock(&wait_recv_resp_mutex);
-	}
-
 	return PLDM_SUCCESS;
 }
 
@@ -548,5 +494,3 @@ int pldm_send_ipmi_request(ipmi_msg *msg)
 
 	return 0;
 }
-
-K_THREAD_DEFINE(pldm_wait_resp_to, 1024, pldm_msg_timeout_monitor, NULL, NULL, NULL, 7, 0, 0);
@@ -32,6 +32,8 @@ extern "C" {
 #define MONITOR_THREAD_STACK_SIZE 1024
 
 #define PLDM_MAX_DATA_SIZE 512
+/* wait for the mctp tx pool to free a response buffer */
+#define PLDM_RESP_BUF_ALLOC_TIMEOUT_MS 100
 
 typedef uint8_t (*pldm_cmd_proc_fn)(void *, uint8_t *, uint16_t, uint8_t, uint8_t *, uint16_t *,
 				    void *);
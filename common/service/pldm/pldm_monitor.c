@@ -26,6 +26,10 @@
 #define PLDM_MONITOR_EVENT_QUEUE_MSG_NUM_MAX PLDM_MONITOR_EVENT_QUEUE_MSG_NUM_MAX_DEFAULT
 #endif
 
+#ifndef PLDM_MONITOR_SENSOR_CACHE_MAX_AGE_MS
+#define PLDM_MONITOR_SENSOR_CACHE_MAX_AGE_MS PLDM_MONITOR_SENSOR_CACHE_MAX_AGE_MS_DEFAULT
+#endif
+
 LOG_MODULE_DECLARE(pldm);
 
 K_FIFO_DEFINE(send_event_pkt_fifo);
@@ -93,7 +97,8 @@ uint8_t pldm_get_sensor_reading(void *mctp_inst, uint8_t *buf, uint16_t len, uin
 	uint8_t status;
 	int reading = 0;
 
-	status = get_sensor_reading(sensor_number, &reading, GET_FROM_CACHE);
+	status = get_sensor_reading_max_age(sensor_number, &reading,
+					    PLDM_MONITOR_SENSOR_CACHE_MAX_AGE_MS);
 
 	switch (status) {
 	case SENSOR_READ_SUCCESS:
@@ -43,6 +43,8 @@ typedef enum pldm_platform_monitor_commands {
 #define PLDM_MONITOR_EVENT_DATA_SIZE_MAX 7
 /* The default maximum event message number in the queue */
 #define PLDM_MONITOR_EVENT_QUEUE_MSG_NUM_MAX_DEFAULT 10
+/* Max age of sensor cache for get sensor reading before falling back to a sensor read */
+#define PLDM_MONITOR_SENSOR_CACHE_MAX_AGE_MS_DEFAULT SENSOR_CACHE_MAX_AGE_UNLIMITED
 #define PLDM_MONITOR_SENSOR_SUPPORT_MAX 0xFF
 #define PLDM_MONITOR_SENSOR_EVENT_SENSOR_OP_STATE_DATA_LENGTH 2
 #define PLDM_MONITOR_SENSOR_EVENT_STATE_SENSOR_STATE_DATA_LENGTH 3
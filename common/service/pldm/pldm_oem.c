@@ -136,10 +136,8 @@ static uint8_t ipmi_cmd(void *mctp_inst, uint8_t *buf, uint16_t len, uint8_t ins
 	/* store the pldm header in the buffer */
 	memcpy(msg.buffer.data + pldm_hdr_ofs, buf - sizeof(pldm_hdr), sizeof(pldm_hdr));
 
-	while (k_msgq_put(&ipmi_msgq, &msg, K_NO_WAIT) != 0) {
-		k_msgq_purge(&ipmi_msgq);
-		LOG_WRN("Retrying put ipmi msgq");
-	}
+	/* node busy is responded by pldm if the queue is full */
+	ipmi_msgq_put(&msg, K_NO_WAIT);
 
 	return PLDM_LATER_RESP;
 }
@@ -89,13 +89,14 @@ int get_sdr_index(uint8_t sensor_num)
 		return -1;
 	}
 
-	uint8_t i = 0;
-	for (i = 0; i < sdr_count; ++i) {
-		if (sensor_num == full_sdr_table[i].sensor_num) {
-			return i;
-		}
+	if (sensor_num >= SENSOR_NUM_MAX) {
+		return SENSOR_NUM_MAX;
+	}
+
+	if (sdr_index_map[sensor_num] == SENSOR_NULL) {
+		return SENSOR_NUM_MAX;
 	}
-	return SENSOR_NUM_MAX;
+	return sdr_index_map[sensor_num];
 }
 
 void add_full_sdr_table(SDR_Full_sensor add_item)
@@ -105,6 +106,9 @@ void add_full_sdr_table(SDR_Full_sensor add_item)
 		return;
 	}
 
+	// Index entries copied into the table since init, e.g. by pal_extend_full_sdr_table()
+	map_sensor_num_to_sdr_cfg();
+
 	int index = get_sdr_index(add_item.sensor_num);
 	if (index == -1) {
 		LOG_ERR("Fail to get sdr index");
@@ -119,6 +123,7 @@ void add_full_sdr_table(SDR_Full_sensor add_item)
 	// Check SDR table size before adding SDR
 	if (sdr_count + 1 <= sensor_config_size) {
 		full_sdr_table[sdr_count++] = add_item;
+		map_sensor_num_to_sdr_cfg();
 	} else {
 		LOG_ERR("Add SDR would over SDR max size");
 	}
@@ -476,6 +476,7 @@ bool SDR_RSV_ID_check(uint16_t ID, uint8_t rsv_table_index);
 uint8_t sdr_init(void);
 void pal_fix_full_sdr_table(void);
 bool check_sdr_num_exist(uint8_t sensor_num);
+int get_sdr_index(uint8_t sensor_num);
 void add_full_sdr_table(SDR_Full_sensor add_item);
 void change_sensor_threshold(uint8_t sensor_num, uint8_t threshold_type, uint8_t change_value);
 void change_sensor_mbr(uint8_t sensor_num, uint8_t mbr_type, uint16_t change_value);
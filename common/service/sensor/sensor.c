@@ -30,6 +30,9 @@
 #include "util_sys.h"
 #include "plat_def.h"
 #include "libutil.h"
+#include "util_pmbus.h"
+#include "sensor_threshold.h"
+#include "sensor_history.h"
 
 #include <logging/log.h>
 
@@ -44,12 +47,45 @@ LOG_MODULE_REGISTER(sensor);
 
 #define SENSOR_READ_RETRY_MAX 3
 
+#ifndef SENSOR_POLL_THREAD_MAX
+#define SENSOR_POLL_THREAD_MAX SENSOR_POLL_THREAD_MAX_DEFAULT
+#endif
+
+#define MAX_SENSOR_POLL_THREAD_NAME_LEN 16
+
 extern sensor_cfg plat_sensor_config[];
 extern const int SENSOR_CONFIG_SIZE;
 
 struct k_thread sensor_poll;
 K_KERNEL_STACK_MEMBER(sensor_poll_stack, SENSOR_POLL_STACK_SIZE);
 
+#if SENSOR_POLL_THREAD_MAX > 1
+static struct k_thread sensor_poll_worker[SENSOR_POLL_THREAD_MAX - 1];
+K_KERNEL_STACK_ARRAY_DEFINE(sensor_poll_worker_stack, SENSOR_POLL_THREAD_MAX - 1,
+			    SENSOR_POLL_STACK_SIZE);
+#endif
+
+typedef struct _sensor_poll_schedule {
+	// Min-heap of sensor config index, ordered by next poll time then by index
+	uint8_t *heap;
+	uint8_t count;
+	int64_t scan_time_ms;
+	int64_t max_scan_time_ms;
+} sensor_poll_schedule;
+
+static sensor_poll_schedule sensor_poll_schedules[SENSOR_POLL_THREAD_MAX];
+static sensor_poll_bus_stat sensor_poll_bus[SENSOR_POLL_BUS_MAX];
+static int64_t sensor_poll_bus_scan_time[SENSOR_POLL_BUS_MAX];
+static uint8_t sensor_poll_bus_count = 0;
+static uint8_t sensor_poll_worker_count = 1;
+static atomic_t sensor_poll_ready_worker_count = ATOMIC_INIT(0);
+static int sensor_poll_interval_ms = 1000;
+// Mapping sensor config index to polling group, allocated at sensor_poll_init
+static uint8_t *sensor_poll_group_map = NULL;
+// Sensors read behind the same pre/post read hooks, linked from the leader in the poll heap
+static uint8_t *sensor_poll_batch_next = NULL;
+static bool *sensor_poll_is_batch_member = NULL;
+
 uint8_t sensor_config_index_map[SENSOR_NUM_MAX];
 uint8_t sdr_index_map[SENSOR_NUM_MAX];
 
@@ -204,41 +240,60 @@ struct sensor_drive_api {
 	SENSOR_DRIVE_TYPE_INIT_MAP(pt5161l),
 };
 
+// Number of leading table entries already indexed in sdr_index_map/sensor_config_index_map
+static uint8_t sdr_index_map_count = 0;
+static uint8_t sensor_config_index_map_count = 0;
+// Serialize map updates, lookups only read the maps and don't take it
+K_MUTEX_DEFINE(sensor_index_map_mutex);
+
 static void init_sensor_num(void)
 {
 	for (int i = 0; i < SENSOR_NUM_MAX; i++) {
 		sdr_index_map[i] = 0xFF;
 		sensor_config_index_map[i] = 0xFF;
 	}
+	sdr_index_map_count = 0;
+	sensor_config_index_map_count = 0;
 }
 
+/*
+ * Index the table entries appended since the last call, so sensor number lookups stay O(1)
+ * whether the tables are filled by memcpy in load_sdr_table()/load_sensor_config() or by
+ * add_full_sdr_table()/add_sensor_config(). The first entry of a duplicated sensor number wins,
+ * the same as a linear search from the table head. It's called at init and when a table entry
+ * is added, get_sensor_config_index()/get_sdr_index() never update the maps.
+ */
 void map_sensor_num_to_sdr_cfg(void)
 {
-	uint8_t i, j;
+	k_mutex_lock(&sensor_index_map_mutex, K_FOREVER);
 
-	for (i = 0; i < SENSOR_NUM_MAX; i++) {
-		for (j = 0; j < sdr_count; j++) {
-			if (i == full_sdr_table[j].sensor_num) {
-				sdr_index_map[i] = j;
-				break;
-			} else if (i == sdr_count) {
-				sdr_index_map[i] = SENSOR_NULL;
-			} else {
-				continue;
+	if ((sdr_index_map_count > sdr_count) ||
+	    (sensor_config_index_map_count > sensor_config_count)) {
+		// Table was reloaded with fewer entries, rebuild from scratch
+		init_sensor_num();
+	}
+
+	if (full_sdr_table != NULL) {
+		for (; sdr_index_map_count < sdr_count; sdr_index_map_count++) {
+			uint8_t num = full_sdr_table[sdr_index_map_count].sensor_num;
+			if ((num < SENSOR_NUM_MAX) && (sdr_index_map[num] == SENSOR_NULL)) {
+				sdr_index_map[num] = sdr_index_map_count;
 			}
 		}
-		for (j = 0; j < sdr_count; j++) {
-			if (i == sensor_config[j].num) {
-				sensor_config_index_map[i] = j;
-				break;
-			} else if (i == sdr_count) {
-				sensor_config_index_map[i] = SENSOR_NULL;
-			} else {
-				continue;
+	}
+
+	if (sensor_config != NULL) {
+		for (; sensor_config_index_map_count < sensor_config_count;
+		     sensor_config_index_map_count++) {
+			uint8_t num = sensor_config[sensor_config_index_map_count].num;
+			if ((num < SENSOR_NUM_MAX) &&
+			    (sensor_config_index_map[num] == SENSOR_NULL)) {
+				sensor_config_index_map[num] = sensor_config_index_map_count;
 			}
 		}
 	}
-	return;
+
+	k_mutex_unlock(&sensor_index_map_mutex);
 }
 
 bool access_check(uint8_t sensor_num)
@@ -256,6 +311,44 @@ void clear_unaccessible_sensor_cache(uint8_t sensor_num)
 		sensor_config[sensor_config_index_map[sensor_num]].cache_status =
 			SENSOR_INIT_STATUS;
 	}
+	sensor_threshold_clear(sensor_num);
+}
+
+static void update_sensor_cache(uint8_t sensor_num, sensor_cfg *cfg, int *reading)
+{
+	memcpy(&cfg->cache, reading, sizeof(*reading));
+	cfg->cache_status = SENSOR_READ_4BYTE_ACUR_SUCCESS;
+	cfg->cache_sample_time = k_uptime_get();
+	sensor_threshold_check(sensor_num, reading);
+	sensor_history_record(sensor_num, reading);
+}
+
+/* Store the result of a sensor driver read done outside get_sensor_reading(), e.g. by a batched
+ * PMBus read, with the same cache and retry handling as GET_FROM_SENSOR.
+ */
+uint8_t update_sensor_read_result(uint8_t sensor_num, uint8_t read_status, int *reading)
+{
+	CHECK_NULL_ARG_WITH_RETURN(reading, SENSOR_UNSPECIFIED_ERROR);
+
+	sensor_cfg *cfg = &sensor_config[sensor_config_index_map[sensor_num]];
+
+	if (read_status == SENSOR_READ_SUCCESS || read_status == SENSOR_READ_ACUR_SUCCESS) {
+		cfg->retry = 0;
+		if (!access_check(sensor_num)) {
+			clear_unaccessible_sensor_cache(sensor_num);
+			cfg->cache_status = SENSOR_NOT_ACCESSIBLE;
+			return cfg->cache_status;
+		}
+		update_sensor_cache(sensor_num, cfg, reading);
+		return cfg->cache_status;
+	}
+
+	if (cfg->retry >= SENSOR_READ_RETRY_MAX) {
+		cfg->cache_status = read_status;
+	} else {
+		cfg->retry++;
+	}
+	return cfg->cache_status;
 }
 
 uint8_t get_sensor_reading(uint8_t sensor_num, int *reading, uint8_t read_mode)
@@ -323,8 +416,7 @@ uint8_t get_sensor_reading(uint8_t sensor_num, int *reading, uint8_t read_mode)
 				cfg->cache_status = SENSOR_POST_READ_ERROR;
 				return cfg->cache_status;
 			}
-			memcpy(&cfg->cache, reading, sizeof(*reading));
-			cfg->cache_status = SENSOR_READ_4BYTE_ACUR_SUCCESS;
+			update_sensor_cache(sensor_num, cfg, reading);
 			return cfg->cache_status;
 		} else {
 			/* Return current status if retry reach max retry count, otherwise return cache status instead of current status */
@@ -385,6 +477,56 @@ uint8_t get_sensor_reading(uint8_t sensor_num, int *reading, uint8_t read_mode)
 	return cfg->cache_status;
 }
 
+/* Age of the cached reading in ms, or -1 if the cache holds no valid reading */
+int64_t get_sensor_cache_age_ms(uint8_t sensor_num)
+{
+	if (sensor_config_index_map[sensor_num] == SENSOR_FAIL) {
+		return -1;
+	}
+
+	sensor_cfg *cfg = &sensor_config[sensor_config_index_map[sensor_num]];
+	switch (cfg->cache_status) {
+	case SENSOR_READ_SUCCESS:
+	case SENSOR_READ_ACUR_SUCCESS:
+	case SENSOR_READ_4BYTE_ACUR_SUCCESS:
+		return k_uptime_get() - cfg->cache_sample_time;
+	default:
+		return -1;
+	}
+}
+
+/* Return the cached reading if it was sampled within max_age_ms, otherwise read the sensor
+ * synchronously. Only a stale successful reading is read again, any other cache status, e.g.
+ * polling disabled, not ready yet or a failed read, is returned as is without touching the bus.
+ * Neither is the bus touched while sensor polling is disabled, e.g. during firmware update.
+ */
+uint8_t get_sensor_reading_max_age(uint8_t sensor_num, int *reading, uint32_t max_age_ms)
+{
+	uint8_t status = get_sensor_reading(sensor_num, reading, GET_FROM_CACHE);
+
+	switch (status) {
+	case SENSOR_READ_SUCCESS:
+	case SENSOR_READ_ACUR_SUCCESS:
+	case SENSOR_READ_4BYTE_ACUR_SUCCESS:
+		break;
+	default:
+		return status;
+	}
+
+	if ((max_age_ms == SENSOR_CACHE_MAX_AGE_UNLIMITED) ||
+	    (get_sensor_cache_age_ms(sensor_num) <= max_age_ms)) {
+		return status;
+	}
+
+	sensor_cfg *cfg = &sensor_config[sensor_config_index_map[sensor_num]];
+	if ((sensor_poll_enable_flag == false) ||
+	    (cfg->is_enable_polling == DISABLE_SENSOR_POLLING)) {
+		return status;
+	}
+
+	return get_sensor_reading(sensor_num, reading, GET_FROM_SENSOR);
+}
+
 void disable_sensor_poll()
 {
 	sensor_poll_enable_flag = false;
@@ -400,63 +542,384 @@ bool get_sensor_poll_enable_flag()
 	return sensor_poll_enable_flag;
 }
 
-void sensor_poll_handler(void *arug0, void *arug1, void *arug2)
+/* The port field of these sensor types is not an i2c bus number,
+ * so they are grouped by sensor type instead.
+ */
+static bool is_i2c_sensor_type(uint8_t type)
 {
-	uint8_t index = 0, sensor_num = 0;
-	int sensor_poll_interval_ms;
-	int reading;
+	switch (type) {
+	case sensor_dev_ast_adc:
+	case sensor_dev_ast_fan:
+	case sensor_dev_intel_peci:
+	case sensor_dev_pch:
+	case sensor_dev_pmic:
+	case sensor_dev_i3c_dimm:
+#ifdef ENABLE_PM8702
+	case sensor_dev_pm8702:
+#endif
+		return false;
+	default:
+		return true;
+	}
+}
 
-	k_msleep(1000); // delay 1 second to wait for drivers ready before start sensor polling
+static int64_t get_sensor_poll_period(sensor_cfg *cfg)
+{
+	if (cfg->poll_interval_ms != 0) {
+		return cfg->poll_interval_ms;
+	}
 
-	pal_set_sensor_poll_interval(&sensor_poll_interval_ms);
+	if (cfg->poll_time != POLL_TIME_DEFAULT) {
+		return cfg->poll_time * 1000;
+	}
 
-	while (1) {
-		for (index = 0; index < sensor_config_count; index++) {
-			// Perform sensor polling according to the sensor number of the sensor config table
-			sensor_num = sensor_config[index].num;
-			if (sensor_poll_enable_flag == false) { /* skip if disable sensor poll */
-				break;
-			}
+	return sensor_poll_interval_ms;
+}
 
-			sensor_cfg *config = &sensor_config[sensor_config_index_map[sensor_num]];
-			if (config->cache_status == SENSOR_NOT_PRESENT) {
+static uint8_t find_sensor_poll_group(sensor_cfg *cfg)
+{
+	bool is_i2c_bus = is_i2c_sensor_type(cfg->type);
+	uint8_t bus = is_i2c_bus ? cfg->port : cfg->type;
+	uint8_t group;
+
+	for (group = 0; group < sensor_poll_bus_count; group++) {
+		if ((sensor_poll_bus[group].is_i2c_bus == is_i2c_bus) &&
+		    (sensor_poll_bus[group].bus == bus)) {
+			return group;
+		}
+	}
+
+	if (sensor_poll_bus_count >= SENSOR_POLL_BUS_MAX) {
+		LOG_ERR("Sensor polling group is full, sensor 0x%x is polled with the last group",
+			cfg->num);
+		return SENSOR_POLL_BUS_MAX - 1;
+	}
+
+	group = sensor_poll_bus_count++;
+	sensor_poll_bus[group].bus = bus;
+	sensor_poll_bus[group].is_i2c_bus = is_i2c_bus;
+	return group;
+}
+
+/* Chain sensors which can share one PMBus batch read behind the first of them in table order,
+ * only the first one is scheduled and reads the others.
+ */
+static void sensor_poll_batch_init(void)
+{
+	uint8_t index, leader, member, batch_size;
+
+	for (index = 0; index < sensor_config_count; index++) {
+		sensor_poll_batch_next[index] = SENSOR_NULL;
+		sensor_poll_is_batch_member[index] = false;
+	}
+
+	for (index = 1; index < sensor_config_count; index++) {
+		for (leader = 0; leader < index; leader++) {
+			if (sensor_poll_is_batch_member[leader] ||
+			    (sensor_poll_group_map[leader] != sensor_poll_group_map[index]) ||
+			    (get_sensor_poll_period(&sensor_config[leader]) !=
+			     get_sensor_poll_period(&sensor_config[index])) ||
+			    !pmbus_is_batch_member(&sensor_config[leader], &sensor_config[index])) {
 				continue;
 			}
 
-			// Check whether monitoring sensor is enabled
-			if (config->is_enable_polling == DISABLE_SENSOR_POLLING) {
-				config->cache = SENSOR_FAIL;
-				config->cache_status = SENSOR_POLLING_DISABLE;
+			batch_size = 1;
+			for (member = leader; sensor_poll_batch_next[member] != SENSOR_NULL;
+			     member = sensor_poll_batch_next[member]) {
+				batch_size++;
+			}
+			if (batch_size >= PMBUS_BATCH_MAX) {
 				continue;
 			}
 
-			if (sdr_index_map[sensor_num] == SENSOR_NULL) { // Check sensor info
-				LOG_ERR("Fail to find sensor SDR info, sensor number: 0x%x",
-					sensor_num);
+			sensor_poll_batch_next[member] = index;
+			sensor_poll_is_batch_member[index] = true;
+			break;
+		}
+	}
+}
+
+static bool sensor_poll_group_init(void)
+{
+	uint8_t index, group, worker;
+	uint8_t *heap;
+
+	sensor_poll_group_map = (uint8_t *)malloc(sensor_config_count * sizeof(uint8_t));
+	sensor_poll_batch_next = (uint8_t *)malloc(sensor_config_count * sizeof(uint8_t));
+	sensor_poll_is_batch_member = (bool *)malloc(sensor_config_count * sizeof(bool));
+	heap = (uint8_t *)malloc(sensor_config_count * sizeof(uint8_t));
+	if ((sensor_poll_group_map == NULL) || (sensor_poll_batch_next == NULL) ||
+	    (sensor_poll_is_batch_member == NULL) || (heap == NULL)) {
+		SAFE_FREE(sensor_poll_group_map);
+		SAFE_FREE(sensor_poll_batch_next);
+		SAFE_FREE(sensor_poll_is_batch_member);
+		SAFE_FREE(heap);
+		LOG_ERR("Fail to allocate memory to sensor polling schedule");
+		return false;
+	}
+
+	for (index = 0; index < sensor_config_count; index++) {
+		group = find_sensor_poll_group(&sensor_config[index]);
+		sensor_poll_group_map[index] = group;
+		sensor_poll_bus[group].sensor_count++;
+	}
+
+	sensor_poll_batch_init();
+
+	sensor_poll_worker_count = MIN(SENSOR_POLL_THREAD_MAX, sensor_poll_bus_count);
+	if (sensor_poll_worker_count == 0) {
+		sensor_poll_worker_count = 1;
+	}
+
+	// Keep each bus on one thread, so sensors on the same bus are still polled in table order
+	for (group = 0; group < sensor_poll_bus_count; group++) {
+		sensor_poll_bus[group].worker = group % sensor_poll_worker_count;
+	}
+
+	/* Every sensor is due at start, filling the heap in index order
+	 * keeps the first scan in sensor config table order.
+	 */
+	for (worker = 0; worker < sensor_poll_worker_count; worker++) {
+		sensor_poll_schedules[worker].heap = heap;
+		for (index = 0; index < sensor_config_count; index++) {
+			if (sensor_poll_bus[sensor_poll_group_map[index]].worker != worker) {
 				continue;
 			}
-
-			if (sensor_config[index].poll_time != POLL_TIME_DEFAULT) {
-				if (pal_is_time_to_poll(sensor_num,
-							sensor_config[index].poll_time) == false) {
-					continue;
-				}
+			sensor_config[index].next_poll_time = 0;
+			if (sensor_poll_is_batch_member[index]) {
+				// Read by its batch leader
+				continue;
 			}
+			*heap++ = index;
+			sensor_poll_schedules[worker].count++;
+		}
+	}
 
-			get_sensor_reading(sensor_num, &reading, GET_FROM_SENSOR);
+	return true;
+}
 
-			k_yield();
+static bool is_sensor_poll_earlier(uint8_t index_a, uint8_t index_b)
+{
+	if (sensor_config[index_a].next_poll_time != sensor_config[index_b].next_poll_time) {
+		return sensor_config[index_a].next_poll_time <
+		       sensor_config[index_b].next_poll_time;
+	}
+	return index_a < index_b;
+}
+
+/* Move the heap root down after its next poll time is pushed back */
+static void sensor_poll_schedule_sift_down(sensor_poll_schedule *schedule)
+{
+	uint16_t pos = 0, child, earliest;
+	uint8_t tmp;
+
+	while (1) {
+		earliest = pos;
+		child = (pos * 2) + 1;
+		if ((child < schedule->count) &&
+		    is_sensor_poll_earlier(schedule->heap[child], schedule->heap[earliest])) {
+			earliest = child;
+		}
+		child++;
+		if ((child < schedule->count) &&
+		    is_sensor_poll_earlier(schedule->heap[child], schedule->heap[earliest])) {
+			earliest = child;
 		}
+		if (earliest == pos) {
+			return;
+		}
+
+		tmp = schedule->heap[pos];
+		schedule->heap[pos] = schedule->heap[earliest];
+		schedule->heap[earliest] = tmp;
+		pos = earliest;
+	}
+}
+
+static bool is_sensor_poll_needed(uint8_t index)
+{
+	uint8_t sensor_num = sensor_config[index].num;
+
+	sensor_cfg *config = &sensor_config[sensor_config_index_map[sensor_num]];
+	if (config->cache_status == SENSOR_NOT_PRESENT) {
+		return false;
+	}
+
+	// Check whether monitoring sensor is enabled
+	if (config->is_enable_polling == DISABLE_SENSOR_POLLING) {
+		config->cache = SENSOR_FAIL;
+		config->cache_status = SENSOR_POLLING_DISABLE;
+		return false;
+	}
+
+	if (sdr_index_map[sensor_num] == SENSOR_NULL) { // Check sensor info
+		LOG_ERR("Fail to find sensor SDR info, sensor number: 0x%x", sensor_num);
+		return false;
+	}
+
+	return true;
+}
+
+static void sensor_poll_read(uint8_t index)
+{
+	uint8_t group = sensor_poll_group_map[index];
+	uint8_t batch[PMBUS_BATCH_MAX];
+	uint8_t batch_count = 0, member;
+	int64_t read_start_time;
+	int reading;
+
+	for (member = index; member != SENSOR_NULL; member = sensor_poll_batch_next[member]) {
+		if (is_sensor_poll_needed(member)) {
+			batch[batch_count++] = sensor_config[member].num;
+		}
+	}
 
+	if (batch_count == 0) {
+		return;
+	}
+
+	read_start_time = k_uptime_get();
+	if (batch_count == 1) {
+		get_sensor_reading(batch[0], &reading, GET_FROM_SENSOR);
+	} else {
+		pmbus_batch_read(batch, batch_count);
+	}
+	sensor_poll_bus_scan_time[group] += k_uptime_get() - read_start_time;
+}
+
+static void sensor_poll_worker_ready(void)
+{
+	if (atomic_inc(&sensor_poll_ready_worker_count) + 1 == sensor_poll_worker_count) {
 		is_sensor_ready_flag = true;
+	}
+}
+
+static void sensor_poll_scan_done(uint8_t worker, int64_t scan_time_ms)
+{
+	sensor_poll_schedule *schedule = &sensor_poll_schedules[worker];
+	uint8_t group;
 
-		k_msleep(sensor_poll_interval_ms);
+	for (group = 0; group < sensor_poll_bus_count; group++) {
+		if ((sensor_poll_bus[group].worker != worker) ||
+		    (sensor_poll_bus_scan_time[group] == 0)) {
+			continue;
+		}
+		sensor_poll_bus[group].scan_time_ms = sensor_poll_bus_scan_time[group];
+		sensor_poll_bus[group].max_scan_time_ms =
+			MAX(sensor_poll_bus[group].max_scan_time_ms,
+			    sensor_poll_bus[group].scan_time_ms);
+		sensor_poll_bus_scan_time[group] = 0;
 	}
+
+	schedule->scan_time_ms = scan_time_ms;
+	schedule->max_scan_time_ms = MAX(schedule->max_scan_time_ms, scan_time_ms);
 }
 
-__weak bool pal_is_time_to_poll(uint8_t sensor_num, int poll_time)
+/* Poll the sensors owned by the thread in order of their next poll time,
+ * and sleep until the next sensor is due when nothing needs to be polled.
+ */
+static void sensor_poll_run(uint8_t worker)
 {
-	return true;
+	sensor_poll_schedule *schedule = &sensor_poll_schedules[worker];
+	bool is_first_scan = true;
+	int64_t scan_start_time = 0, current_time, next_poll_time;
+	uint8_t index;
+	sensor_cfg *cfg;
+
+	if (schedule->count == 0) {
+		LOG_ERR("Sensor poll thread %d has no sensor to poll", worker);
+		sensor_poll_worker_ready();
+		return;
+	}
+
+	while (1) {
+		if (sensor_poll_enable_flag == false) { /* skip if disable sensor poll */
+			k_msleep(sensor_poll_interval_ms);
+			continue;
+		}
+
+		index = schedule->heap[0];
+		cfg = &sensor_config[index];
+		current_time = k_uptime_get();
+
+		/* A polled sensor is always rescheduled after the time it was read, so once the
+		 * root is later than the scan start, every sensor due at that time has been polled.
+		 * This also ends a scan when sensors are due back-to-back under overload.
+		 */
+		if ((scan_start_time != 0) && (cfg->next_poll_time > scan_start_time)) {
+			sensor_poll_scan_done(worker, current_time - scan_start_time);
+			scan_start_time = 0;
+			if (is_first_scan) {
+				is_first_scan = false;
+				sensor_poll_worker_ready();
+			}
+		}
+
+		if (cfg->next_poll_time > current_time) {
+			k_msleep(cfg->next_poll_time - current_time);
+			continue;
+		}
+
+		if (scan_start_time == 0) {
+			scan_start_time = current_time;
+		}
+
+		sensor_poll_read(index);
+
+		// Keep the polling period, unless the sensor is already late by more than a period
+		next_poll_time = cfg->next_poll_time + get_sensor_poll_period(cfg);
+		if (next_poll_time <= current_time) {
+			next_poll_time = current_time + get_sensor_poll_period(cfg);
+		}
+		cfg->next_poll_time = next_poll_time;
+		sensor_poll_schedule_sift_down(schedule);
+
+		k_yield();
+	}
+}
+
+#if SENSOR_POLL_THREAD_MAX > 1
+static void sensor_poll_worker_handler(void *arug0, void *arug1, void *arug2)
+{
+	ARG_UNUSED(arug1);
+	ARG_UNUSED(arug2);
+
+	k_msleep(1000); // delay 1 second to wait for drivers ready before start sensor polling
+
+	sensor_poll_run(POINTER_TO_UINT(arug0));
+}
+#endif
+
+void sensor_poll_handler(void *arug0, void *arug1, void *arug2)
+{
+	k_msleep(1000); // delay 1 second to wait for drivers ready before start sensor polling
+
+	// Sensor poll thread polls the buses of the first group
+	sensor_poll_run(0);
+}
+
+uint8_t get_sensor_poll_bus_stat(sensor_poll_bus_stat *stat, uint8_t max_count)
+{
+	CHECK_NULL_ARG_WITH_RETURN(stat, 0);
+
+	uint8_t count = MIN(max_count, sensor_poll_bus_count);
+	memcpy(stat, sensor_poll_bus, count * sizeof(sensor_poll_bus_stat));
+	return count;
+}
+
+void get_sensor_poll_scan_time(int64_t *scan_time_ms, int64_t *max_scan_time_ms)
+{
+	CHECK_NULL_ARG(scan_time_ms);
+	CHECK_NULL_ARG(max_scan_time_ms);
+
+	// Poll threads scan in parallel, so the full table refresh takes as long as the slowest one
+	*scan_time_ms = 0;
+	*max_scan_time_ms = 0;
+	for (uint8_t worker = 0; worker < sensor_poll_worker_count; worker++) {
+		*scan_time_ms = MAX(*scan_time_ms, sensor_poll_schedules[worker].scan_time_ms);
+		*max_scan_time_ms =
+			MAX(*max_scan_time_ms, sensor_poll_schedules[worker].max_scan_time_ms);
+	}
 }
 
 __weak void pal_set_sensor_poll_interval(int *interval_ms)
@@ -539,6 +1002,28 @@ bool vr_stby_access(uint8_t sensor_num)
 
 void sensor_poll_init()
 {
+	pal_set_sensor_poll_interval(&sensor_poll_interval_ms);
+
+	if (sensor_poll_group_init() == false) {
+		LOG_ERR("BIC would not start sensor thread");
+		return;
+	}
+
+#if SENSOR_POLL_THREAD_MAX > 1
+	uint8_t worker;
+	char thread_name[MAX_SENSOR_POLL_THREAD_NAME_LEN];
+
+	for (worker = 1; worker < sensor_poll_worker_count; worker++) {
+		k_thread_create(&sensor_poll_worker[worker - 1],
+				sensor_poll_worker_stack[worker - 1],
+				K_KERNEL_STACK_SIZEOF(sensor_poll_worker_stack[worker - 1]),
+				sensor_poll_worker_handler, UINT_TO_POINTER(worker), NULL, NULL,
+				CONFIG_MAIN_THREAD_PRIORITY, 0, K_NO_WAIT);
+		snprintf(thread_name, sizeof(thread_name), "sensor_poll_%d", worker);
+		k_thread_name_set(&sensor_poll_worker[worker - 1], thread_name);
+	}
+#endif
+
 	k_thread_create(&sensor_poll, sensor_poll_stack, K_THREAD_STACK_SIZEOF(sensor_poll_stack),
 			sensor_poll_handler, NULL, NULL, NULL, CONFIG_MAIN_THREAD_PRIORITY, 0,
 			K_NO_WAIT);
@@ -548,19 +1033,70 @@ void sensor_poll_init()
 
 uint8_t get_sensor_config_index(uint8_t sensor_num)
 {
-	uint8_t i = 0;
-	for (i = 0; i < sensor_config_count; ++i) {
-		if (sensor_num == sensor_config[i].num) {
-			return i;
-		}
+	if (sensor_num >= SENSOR_NUM_MAX) {
+		return SENSOR_NUM_MAX;
+	}
+
+	if (sensor_config_index_map[sensor_num] == SENSOR_NULL) {
+		return SENSOR_NUM_MAX;
+	}
+	return sensor_config_index_map[sensor_num];
+}
+
+bool check_sensor_num_exist(uint8_t sensor_num)
+{
+	return (get_sensor_config_index(sensor_num) != SENSOR_NUM_MAX);
+}
+
+/* Once the polling schedule is built, a replaced config has to stay on the same bus and keep
+ * its batch, and new sensors can't be added since no poll thread owns them.
+ */
+static bool is_sensor_config_schedulable(uint8_t index, sensor_cfg *config)
+{
+	if (sensor_poll_group_map == NULL) {
+		return true;
+	}
+
+	if (index == SENSOR_NUM_MAX) {
+		LOG_ERR("Sensor polling is started, can't add sensor[0x%02x]", config->num);
+		return false;
+	}
+
+	sensor_cfg *current = &sensor_config[index];
+	if ((is_i2c_sensor_type(config->type) != is_i2c_sensor_type(current->type)) ||
+	    (is_i2c_sensor_type(config->type) ? (config->port != current->port) :
+						(config->type != current->type))) {
+		LOG_ERR("Sensor polling is started, can't move sensor[0x%02x] to another bus",
+			config->num);
+		return false;
+	}
+
+	bool is_batch_read = sensor_poll_is_batch_member[index] ||
+			     (sensor_poll_batch_next[index] != SENSOR_NULL);
+	bool is_period_changed =
+		(get_sensor_poll_period(config) != get_sensor_poll_period(current));
+	if (is_batch_read && ((config->type != current->type) || is_period_changed)) {
+		LOG_ERR("Sensor polling is started, can't change batch read sensor[0x%02x]",
+			config->num);
+		return false;
 	}
-	return SENSOR_NUM_MAX;
+
+	return true;
 }
 
 void add_sensor_config(sensor_cfg config)
 {
+	// Index entries copied into the table since init, e.g. by pal_extend_sensor_config()
+	map_sensor_num_to_sdr_cfg();
+
 	uint8_t index = get_sensor_config_index(config.num);
+	if (is_sensor_config_schedulable(index, &config) == false) {
+		return;
+	}
+
 	if (index != SENSOR_NUM_MAX) {
+		// Keep the place in the polling schedule, the new period applies from the next poll
+		config.next_poll_time = sensor_config[index].next_poll_time;
 		memcpy(&sensor_config[index], &config, sizeof(sensor_cfg));
 		LOG_ERR("Replace the sensor[0x%02x] configuration", config.num);
 		return;
@@ -568,6 +1104,7 @@ void add_sensor_config(sensor_cfg config)
 	// Check config table size before adding sensor config
 	if (sensor_config_count + 1 <= sdr_count) {
 		sensor_config[sensor_config_count++] = config;
+		map_sensor_num_to_sdr_cfg();
 	} else {
 		LOG_ERR("Add config would over config max size");
 	}
@@ -655,6 +1192,7 @@ bool sensor_init(void)
 	}
 
 	map_sensor_num_to_sdr_cfg();
+	sensor_history_init();
 
 	/* register read api of sensor_config */
 	drive_init();
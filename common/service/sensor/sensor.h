@@ -28,11 +28,19 @@
 #define sensor_name_to_num(x) #x,
 
 #define SENSOR_POLL_STACK_SIZE 2048
+/* Sensors are grouped by bus and each group is polled by one of the poll threads,
+ * platform could define SENSOR_POLL_THREAD_MAX to poll independent buses concurrently.
+ */
+#define SENSOR_POLL_THREAD_MAX_DEFAULT 1
+#define SENSOR_POLL_BUS_MAX 32
 #define NONE 0
 
 #define GET_FROM_CACHE 0x00
 #define GET_FROM_SENSOR 0x01
 
+/* max_age_ms of get_sensor_reading_max_age() to accept a cache value of any age */
+#define SENSOR_CACHE_MAX_AGE_UNLIMITED 0xFFFFFFFF
+
 #define SENSOR_NULL 0xFF
 #define SENSOR_FAIL 0xFF
 #define SENSOR_NUM_MAX 0xFF
@@ -228,12 +236,23 @@ typedef struct _sensor_cfg__ {
 	uint8_t retry;
 	uint8_t (*init)(uint8_t, int *);
 	uint8_t (*read)(uint8_t, int *);
+
+	/* Polling period in millisecond, set by designated initializer if the sensor needs
+	 * a period other than poll_time. 0 means following poll_time.
+	 */
+	uint32_t poll_interval_ms;
+	int64_t next_poll_time; // ms, maintained by sensor polling scheduler
+	int64_t cache_sample_time; // ms, uptime when cache was last read from sensor
 } sensor_cfg;
 
-typedef struct _sensor_poll_time_cfg {
-	uint8_t sensor_num;
-	int64_t last_access_time;
-} sensor_poll_time_cfg;
+typedef struct _sensor_poll_bus_stat {
+	uint8_t bus; // i2c bus of the group, or sensor type for non-i2c sensors
+	bool is_i2c_bus;
+	uint8_t worker;
+	uint8_t sensor_count;
+	int64_t scan_time_ms; // bus busy time of the last scan
+	int64_t max_scan_time_ms;
+} sensor_poll_bus_stat;
 
 typedef struct _vr_page_cfg {
 	uint8_t vr_page;
@@ -569,8 +588,12 @@ extern uint8_t sensor_config_index_map[SENSOR_NUM_MAX];
 extern uint8_t sensor_config_count;
 extern const char *const sensor_type_name[];
 
+bool access_check(uint8_t sensor_num);
 void clear_unaccessible_sensor_cache(uint8_t sensor_num);
+uint8_t update_sensor_read_result(uint8_t sensor_num, uint8_t read_status, int *reading);
 uint8_t get_sensor_reading(uint8_t sensor_num, int *reading, uint8_t read_mode);
+uint8_t get_sensor_reading_max_age(uint8_t sensor_num, int *reading, uint32_t max_age_ms);
+int64_t get_sensor_cache_age_ms(uint8_t sensor_num);
 void pal_set_sensor_poll_interval(int *interval_ms);
 bool stby_access(uint8_t sensor_num);
 bool dc_access(uint8_t sensor_num);
@@ -584,13 +607,16 @@ void enable_sensor_poll();
 bool get_sensor_poll_enable_flag();
 void pal_extend_sensor_config(void);
 bool check_sensor_num_exist(uint8_t sensor_num);
+uint8_t get_sensor_config_index(uint8_t sensor_num);
+void map_sensor_num_to_sdr_cfg(void);
 void add_sensor_config(sensor_cfg config);
 bool check_is_sensor_ready();
-bool pal_is_time_to_poll(uint8_t sensor_num, int poll_time);
 uint8_t plat_get_config_size();
 void load_sensor_config(void);
 void control_sensor_polling(uint8_t sensor_num, uint8_t optional, uint8_t cache_status);
 bool check_reading_pointer_null_is_allowed(uint8_t sensor_num);
 bool init_drive_type_delayed(sensor_cfg *cfg);
+uint8_t get_sensor_poll_bus_stat(sensor_poll_bus_stat *stat, uint8_t max_count);
+void get_sensor_poll_scan_time(int64_t *scan_time_ms, int64_t *max_scan_time_ms);
 
 #endif
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sensor_history.h"
+
+#include <zephyr.h>
+#include <string.h>
+#include <logging/log.h>
+#include "sensor.h"
+#include "libutil.h"
+
+LOG_MODULE_REGISTER(sensor_history);
+
+#ifndef SENSOR_HISTORY_SLOT_MAX
+#define SENSOR_HISTORY_SLOT_MAX SENSOR_HISTORY_SLOT_MAX_DEFAULT
+#endif
+
+#ifndef SENSOR_HISTORY_DEPTH
+#define SENSOR_HISTORY_DEPTH SENSOR_HISTORY_DEPTH_DEFAULT
+#endif
+
+#define SENSOR_HISTORY_SLOT_NULL 0xFF
+
+__weak bool pal_is_sensor_history_needed(uint8_t sensor_num)
+{
+	return false;
+}
+
+#if SENSOR_HISTORY_SLOT_MAX > 0
+typedef struct _sensor_history_ring {
+	uint16_t head; // index of the next sample to write
+	uint16_t count;
+	sensor_history_sample samples[SENSOR_HISTORY_DEPTH];
+} sensor_history_ring;
+
+static sensor_history_ring history_ring[SENSOR_HISTORY_SLOT_MAX];
+static uint8_t history_slot_map[SENSOR_NUM_MAX];
+static uint8_t history_slot_count;
+K_MUTEX_DEFINE(sensor_history_mutex);
+
+/* Ring index of the i-th newest sample */
+static uint16_t get_sample_index(const sensor_history_ring *ring, uint16_t i)
+{
+	return (ring->head + SENSOR_HISTORY_DEPTH - 1 - i) % SENSOR_HISTORY_DEPTH;
+}
+
+/* Iterate samples from the newest one, stop at the first sample out of the window */
+static uint16_t get_window_sample_count(const sensor_history_ring *ring, uint32_t window_ms)
+{
+	if (window_ms == 0) {
+		return ring->count;
+	}
+
+	uint32_t now = (uint32_t)k_uptime_get();
+	uint16_t count = 0;
+	for (; count < ring->count; count++) {
+		if ((now - ring->samples[get_sample_index(ring, count)].timestamp) > window_ms) {
+			break;
+		}
+	}
+	return count;
+}
+
+void sensor_history_init(void)
+{
+	memset(history_slot_map, SENSOR_HISTORY_SLOT_NULL, sizeof(history_slot_map));
+	memset(history_ring, 0, sizeof(history_ring));
+	history_slot_count = 0;
+
+	for (uint8_t i = 0; i < sensor_config_count; i++) {
+		uint8_t sensor_num = sensor_config[i].num;
+		if ((history_slot_map[sensor_num] != SENSOR_HISTORY_SLOT_NULL) ||
+		    !pal_is_sensor_history_needed(sensor_num)) {
+			continue;
+		}
+		if (history_slot_count >= SENSOR_HISTORY_SLOT_MAX) {
+			LOG_ERR("No history slot for sensor 0x%x", sensor_num);
+			continue;
+		}
+		history_slot_map[sensor_num] = history_slot_count++;
+	}
+}
+
+bool is_sensor_history_enabled(uint8_t sensor_num)
+{
+	return (history_slot_map[sensor_num] != SENSOR_HISTORY_SLOT_NULL);
+}
+
+void sensor_history_record(uint8_t sensor_num, int *reading)
+{
+	CHECK_NULL_ARG(reading);
+
+	if (history_slot_map[sensor_num] == SENSOR_HISTORY_SLOT_NULL) {
+		return;
+	}
+
+	sensor_val *sval = (sensor_val *)reading;
+	sensor_history_ring *ring = &history_ring[history_slot_map[sensor_num]];
+
+	k_mutex_lock(&sensor_history_mutex, K_FOREVER);
+	ring->samples[ring->head].value = (sval->integer * 1000) + sval->fraction;
+	ring->samples[ring->head].timestamp = (uint32_t)k_uptime_get();
+	ring->head = (ring->head + 1) % SENSOR_HISTORY_DEPTH;
+	if (ring->count < SENSOR_HISTORY_DEPTH) {
+		ring->count++;
+	}
+	k_mutex_unlock(&sensor_history_mutex);
+}
+
+/* Get min/max/average of samples taken within the last window_ms, 0 means all samples */
+bool sensor_history_get_stat(uint8_t sensor_num, uint32_t window_ms, sensor_history_stat *stat)
+{
+	CHECK_NULL_ARG_WITH_RETURN(stat, false);
+
+	if (history_slot_map[sensor_num] == SENSOR_HISTORY_SLOT_NULL) {
+		return false;
+	}
+
+	sensor_history_ring *ring = &history_ring[history_slot_map[sensor_num]];
+	int64_t sum = 0;
+
+	memset(stat, 0, sizeof(*stat));
+	k_mutex_lock(&sensor_history_mutex, K_FOREVER);
+	stat->count = get_window_sample_count(ring, window_ms);
+	for (uint16_t i = 0; i < stat->count; i++) {
+		int32_t value = ring->samples[get_sample_index(ring, i)].value;
+		if ((i == 0) || (value < stat->min)) {
+			stat->min = value;
+		}
+		if ((i == 0) || (value > stat->max)) {
+			stat->max = value;
+		}
+		sum += value;
+	}
+	k_mutex_unlock(&sensor_history_mutex);
+
+	if (stat->count) {
+		stat->avg = (int32_t)(sum / stat->count);
+	}
+	return true;
+}
+
+/* Copy up to max_count samples taken within the last window_ms, newest first */
+uint8_t sensor_history_get_samples(uint8_t sensor_num, uint32_t window_ms,
+				   sensor_history_sample *samples, uint8_t max_count)
+{
+	CHECK_NULL_ARG_WITH_RETURN(samples, 0);
+
+	if (history_slot_map[sensor_num] == SENSOR_HISTORY_SLOT_NULL) {
+		return 0;
+	}
+
+	sensor_history_ring *ring = &history_ring[history_slot_map[sensor_num]];
+
+	k_mutex_lock(&sensor_history_mutex, K_FOREVER);
+	uint8_t count = MIN(get_window_sample_count(ring, window_ms), max_count);
+	for (uint8_t i = 0; i < count; i++) {
+		samples[i] = ring->samples[get_sample_index(ring, i)];
+	}
+	k_mutex_unlock(&sensor_history_mutex);
+
+	return count;
+}
+#else
+void sensor_history_init(void)
+{
+	return;
+}
+
+bool is_sensor_history_enabled(uint8_t sensor_num)
+{
+	return false;
+}
+
+void sensor_history_record(uint8_t sensor_num, int *reading)
+{
+	return;
+}
+
+bool sensor_history_get_stat(uint8_t sensor_num, uint32_t window_ms, sensor_history_stat *stat)
+{
+	return false;
+}
+
+uint8_t sensor_history_get_samples(uint8_t sensor_num, uint32_t window_ms,
+				   sensor_history_sample *samples, uint8_t max_count)
+{
+	return 0;
+}
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Number of sensors which keep a reading history and samples kept per sensor,
+ * platform could define SENSOR_HISTORY_SLOT_MAX and SENSOR_HISTORY_DEPTH to enable it.
+ */
+#define SENSOR_HISTORY_SLOT_MAX_DEFAULT 0
+#define SENSOR_HISTORY_DEPTH_DEFAULT 64
+
+/* Max number of raw samples returned by one query */
+#define SENSOR_HISTORY_QUERY_SAMPLE_MAX 16
+
+typedef struct _sensor_history_sample {
+	int32_t value; // reading in 0.001 unit
+	uint32_t timestamp; // ms, lower 32 bits of uptime
+} sensor_history_sample;
+
+typedef struct _sensor_history_stat {
+	uint16_t count; // samples within the window
+	int32_t min; // 0.001 unit
+	int32_t max;
+	int32_t avg;
+} sensor_history_stat;
+
+void sensor_history_init(void);
+bool is_sensor_history_enabled(uint8_t sensor_num);
+void sensor_history_record(uint8_t sensor_num, int *reading);
+bool sensor_history_get_stat(uint8_t sensor_num, uint32_t window_ms, sensor_history_stat *stat);
+uint8_t sensor_history_get_samples(uint8_t sensor_num, uint32_t window_ms,
+				   sensor_history_sample *samples, uint8_t max_count);
+bool pal_is_sensor_history_needed(uint8_t sensor_num);
+
+#endif
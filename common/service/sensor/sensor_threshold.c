@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sensor_threshold.h"
+
+#include <zephyr.h>
+#include <string.h>
+#include <logging/log.h>
+#include "sensor.h"
+#include "sdr.h"
+#include "ipmi.h"
+#include "plat_ipmb.h"
+#include "pldm_monitor.h"
+#include "libutil.h"
+
+LOG_MODULE_REGISTER(sensor_threshold);
+
+#ifndef SENSOR_THRESHOLD_EVENT_QUEUE_SIZE
+#define SENSOR_THRESHOLD_EVENT_QUEUE_SIZE SENSOR_THRESHOLD_EVENT_QUEUE_SIZE_DEFAULT
+#endif
+
+typedef struct _sensor_threshold_info {
+	uint8_t threshold;
+	uint8_t readable_bit;
+	bool is_upper;
+	uint8_t event_offset;
+	uint8_t pldm_state;
+} sensor_threshold_info;
+
+/* Ordered from the most to the least severe, so the first asserted entry decides the PLDM
+ * sensor state.
+ */
+static const sensor_threshold_info threshold_info[] = {
+	{ THRESHOLD_UNR, IPMI_SDR_UNRT_READABLE, true, IPMI_THRESHOLD_UNR_GOING_HIGH,
+	  PLDM_SENSOR_UPPERFATAL },
+	{ THRESHOLD_LNR, IPMI_SDR_LNRT_READABLE, false, IPMI_THRESHOLD_LNR_GOING_LOW,
+	  PLDM_SENSOR_LOWERFATAL },
+	{ THRESHOLD_UCR, IPMI_SDR_UCT_READABLE, true, IPMI_THRESHOLD_UCR_GOING_HIGH,
+	  PLDM_SENSOR_UPPERCRITICAL },
+	{ THRESHOLD_LCR, IPMI_SDR_LCT_READABLE, false, IPMI_THRESHOLD_LCR_GOING_LOW,
+	  PLDM_SENSOR_LOWERCRITICAL },
+	{ THRESHOLD_UNC, IPMI_SDR_UNCT_READABLE, true, IPMI_THRESHOLD_UNC_GOING_HIGH,
+	  PLDM_SENSOR_UPPERWARNING },
+	{ THRESHOLD_LNC, IPMI_SDR_LNCT_READABLE, false, IPMI_THRESHOLD_LNC_GOING_LOW,
+	  PLDM_SENSOR_LOWERWARNING },
+};
+
+/* updated by the sensor poll workers and GET_FROM_SENSOR reads, cleared by other paths */
+static uint8_t threshold_status[SENSOR_NUM_MAX];
+static struct k_spinlock threshold_status_lock[SENSOR_NUM_MAX];
+
+K_MSGQ_DEFINE(sensor_threshold_event_msgq, sizeof(sensor_threshold_event),
+	      SENSOR_THRESHOLD_EVENT_QUEUE_SIZE, 4);
+
+/* Called from the system workqueue for every threshold state change. By default the event goes
+ * to BMC as a SEL if BMC is reached by IPMB, otherwise as a PLDM sensor event with the sensor
+ * number as sensor id. Platforms could override it to use other targets or drop events.
+ */
+__weak void pal_sensor_threshold_event(const sensor_threshold_event *event)
+{
+	CHECK_NULL_ARG(event);
+
+#if MAX_IPMB_IDX
+	if ((IPMB_inf_index_map[BMC_IPMB] != RESERVED) &&
+	    pal_is_interface_use_ipmb(IPMB_inf_index_map[BMC_IPMB])) {
+		sensor_threshold_add_sel(BMC_IPMB, event);
+		return;
+	}
+#endif
+
+	if (sensor_threshold_send_pldm_event(event->sensor_num, event) != PLDM_SUCCESS) {
+		LOG_ERR("Failed to send threshold PLDM event, sensor 0x%x threshold %d",
+			event->sensor_num, event->threshold);
+	}
+}
+
+static void sensor_threshold_event_handler(struct k_work *work)
+{
+	sensor_threshold_event event;
+
+	while (k_msgq_get(&sensor_threshold_event_msgq, &event, K_NO_WAIT) == 0) {
+		pal_sensor_threshold_event(&event);
+	}
+}
+
+K_WORK_DEFINE(sensor_threshold_event_work, sensor_threshold_event_handler);
+
+static const sensor_threshold_info *get_threshold_info(uint8_t threshold)
+{
+	for (uint8_t i = 0; i < ARRAY_SIZE(threshold_info); i++) {
+		if (threshold_info[i].threshold == threshold) {
+			return &threshold_info[i];
+		}
+	}
+	return NULL;
+}
+
+static uint8_t get_raw_threshold(const SDR_Full_sensor *sdr, uint8_t threshold)
+{
+	switch (threshold) {
+	case THRESHOLD_UNR:
+		return sdr->UNRT;
+	case THRESHOLD_UCR:
+		return sdr->UCT;
+	case THRESHOLD_UNC:
+		return sdr->UNCT;
+	case THRESHOLD_LNR:
+		return sdr->LNRT;
+	case THRESHOLD_LCR:
+		return sdr->LCT;
+	case THRESHOLD_LNC:
+		return sdr->LNCT;
+	default:
+		return 0;
+	}
+}
+
+/* Raw values are compared as signed if the SDR analog data format is 1's or 2's complement */
+static int raw_to_int(const SDR_Full_sensor *sdr, uint8_t raw)
+{
+	return (sdr->sensor_unit1 & 0xC0) ? (int8_t)raw : raw;
+}
+
+/* Reading to SDR raw value, out of range readings are clamped instead of wrapping around into
+ * the opposite threshold.
+ */
+static int reading_to_raw(const SDR_Full_sensor *sdr, uint8_t sensor_num, sensor_val *sval)
+{
+	int raw = calculate_MBR(sensor_num, (int)((sval->integer * 1000) + sval->fraction)) / 1000;
+	int min = (sdr->sensor_unit1 & 0xC0) ? INT8_MIN : 0;
+	int max = (sdr->sensor_unit1 & 0xC0) ? INT8_MAX : UINT8_MAX;
+
+	if (raw < min) {
+		return min;
+	}
+	if (raw > max) {
+		return max;
+	}
+	return raw;
+}
+
+/* Assertion/deassertion event mask bits are the event offsets, bit 8 ~ 11 are the low nibble of
+ * the lower/upper threshold reading mask byte.
+ */
+static bool is_threshold_event_enabled(const SDR_Full_sensor *sdr, uint8_t event_offset,
+				       bool is_assert)
+{
+	if ((sdr->sensor_capabilities & IPMI_SDR_SENSOR_CAP_EVENT_CTRL_NO) ==
+	    IPMI_SDR_SENSOR_CAP_EVENT_CTRL_NO) {
+		return false;
+	}
+
+	uint16_t mask = is_assert ?
+				(sdr->assert_evt_mask | ((sdr->lower_thres_read_mask & 0x0F) << 8)) :
+				(sdr->deassert_evt_mask | ((sdr->upper_thres_read_mask & 0x0F) << 8));
+	return (mask & BIT(event_offset));
+}
+
+static uint8_t get_pldm_state(uint8_t status)
+{
+	for (uint8_t i = 0; i < ARRAY_SIZE(threshold_info); i++) {
+		if (status & threshold_info[i].readable_bit) {
+			return threshold_info[i].pldm_state;
+		}
+	}
+	return PLDM_SENSOR_NORMAL;
+}
+
+/* Evaluate the readable thresholds of a threshold based sensor against a new reading.
+ * An upper threshold asserts when reading >= threshold and deasserts when reading falls below
+ * threshold - positive going hysteresis, lower thresholds work the other way around with
+ * negative going hysteresis. Each state change with its event enabled in the SDR is queued to
+ * pal_sensor_threshold_event().
+ */
+void sensor_threshold_check(uint8_t sensor_num, int *reading)
+{
+	CHECK_NULL_ARG(reading);
+
+	if ((full_sdr_table == NULL) || (sdr_index_map[sensor_num] == SENSOR_NULL)) {
+		return;
+	}
+
+	const SDR_Full_sensor *sdr = &full_sdr_table[sdr_index_map[sensor_num]];
+	if ((sdr->evt_read_type != IPMI_SDR_EVENT_TYPE_THRESHOLD) ||
+	    ((sdr->discrete_thres_read_mask & 0x3F) == 0)) {
+		return;
+	}
+
+	int value = reading_to_raw(sdr, sensor_num, (sensor_val *)reading);
+	uint8_t raw_reading = (uint8_t)value;
+
+	k_spinlock_key_t key = k_spin_lock(&threshold_status_lock[sensor_num]);
+	uint8_t previous_status = threshold_status[sensor_num];
+	uint8_t status = previous_status;
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(threshold_info); i++) {
+		const sensor_threshold_info *info = &threshold_info[i];
+		if ((sdr->discrete_thres_read_mask & info->readable_bit) == 0) {
+			continue;
+		}
+
+		int threshold = raw_to_int(sdr, get_raw_threshold(sdr, info->threshold));
+		bool is_asserted = (status & info->readable_bit);
+		if (info->is_upper) {
+			if (!is_asserted && (value >= threshold)) {
+				status |= info->readable_bit;
+			} else if (is_asserted && (value < threshold - sdr->positive_going_thres)) {
+				status &= ~info->readable_bit;
+			}
+		} else {
+			if (!is_asserted && (value <= threshold)) {
+				status |= info->readable_bit;
+			} else if (is_asserted && (value > threshold + sdr->negative_going_thres)) {
+				status &= ~info->readable_bit;
+			}
+		}
+	}
+	threshold_status[sensor_num] = status;
+	k_spin_unlock(&threshold_status_lock[sensor_num], key);
+
+	if (status == previous_status) {
+		return;
+	}
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(threshold_info); i++) {
+		const sensor_threshold_info *info = &threshold_info[i];
+		bool is_assert = (status & info->readable_bit);
+		if ((((status ^ previous_status) & info->readable_bit) == 0) ||
+		    !is_threshold_event_enabled(sdr, info->event_offset, is_assert)) {
+			continue;
+		}
+
+		sensor_threshold_event event = {
+			.sensor_num = sensor_num,
+			.threshold = info->threshold,
+			.is_assert = is_assert,
+			.raw_reading = raw_reading,
+			.raw_threshold = get_raw_threshold(sdr, info->threshold),
+			.previous_status = previous_status,
+			.status = status,
+		};
+		if (k_msgq_put(&sensor_threshold_event_msgq, &event, K_NO_WAIT) != 0) {
+			LOG_ERR("Threshold event queue full, drop sensor 0x%x threshold %d event",
+				sensor_num, info->threshold);
+		}
+	}
+	k_work_submit(&sensor_threshold_event_work);
+}
+
+/* Forget the threshold state without generating events, e.g. when the sensor is no longer
+ * accessible.
+ */
+void sensor_threshold_clear(uint8_t sensor_num)
+{
+	k_spinlock_key_t key = k_spin_lock(&threshold_status_lock[sensor_num]);
+	threshold_status[sensor_num] = 0;
+	k_spin_unlock(&threshold_status_lock[sensor_num], key);
+}
+
+uint8_t get_sensor_threshold_status(uint8_t sensor_num)
+{
+	k_spinlock_key_t key = k_spin_lock(&threshold_status_lock[sensor_num]);
+	uint8_t status = threshold_status[sensor_num];
+	k_spin_unlock(&threshold_status_lock[sensor_num], key);
+	return status;
+}
+
+bool sensor_threshold_add_sel(uint8_t InF_target, const sensor_threshold_event *event)
+{
+	CHECK_NULL_ARG_WITH_RETURN(event, false);
+
+	const sensor_threshold_info *info = get_threshold_info(event->threshold);
+	if ((info == NULL) || (full_sdr_table == NULL) ||
+	    (sdr_index_map[event->sensor_num] == SENSOR_NULL)) {
+		return false;
+	}
+
+	common_addsel_msg_t sel_msg;
+	memset(&sel_msg, 0, sizeof(sel_msg));
+	sel_msg.InF_target = InF_target;
+	sel_msg.sensor_type = full_sdr_table[sdr_index_map[event->sensor_num]].sensor_type;
+	sel_msg.sensor_number = event->sensor_num;
+	sel_msg.event_type = IPMI_THRESHOLD_EVENT_TYPE;
+	if (!event->is_assert) {
+		sel_msg.event_type |= IPMI_EVENT_DIR_DEASSERT;
+	}
+	sel_msg.event_data1 = IPMI_THRESHOLD_EVENT_DATA1 | info->event_offset;
+	sel_msg.event_data2 = event->raw_reading;
+	sel_msg.event_data3 = event->raw_threshold;
+
+	if (!common_add_sel_evt_record(&sel_msg)) {
+		LOG_ERR("Failed to add threshold SEL, sensor 0x%x threshold %d", event->sensor_num,
+			event->threshold);
+		return false;
+	}
+	return true;
+}
+
+uint8_t sensor_threshold_send_pldm_event(uint16_t sensor_id, const sensor_threshold_event *event)
+{
+	CHECK_NULL_ARG_WITH_RETURN(event, PLDM_ERROR);
+
+	if ((full_sdr_table == NULL) || (sdr_index_map[event->sensor_num] == SENSOR_NULL)) {
+		return PLDM_ERROR;
+	}
+
+	const SDR_Full_sensor *sdr = &full_sdr_table[sdr_index_map[event->sensor_num]];
+	struct pldm_sensor_event_numeric_sensor_state data = { 0 };
+	data.event_state = get_pldm_state(event->status);
+	data.previous_event_state = get_pldm_state(event->previous_status);
+	data.sensor_data_size = (sdr->sensor_unit1 & 0xC0) ? PLDM_SENSOR_DATA_SIZE_SINT8 :
+							     PLDM_SENSOR_DATA_SIZE_UINT8;
+	data.present_reading[0] = event->raw_reading;
+
+	return pldm_send_platform_event(PLDM_SENSOR_EVENT, sensor_id, PLDM_NUMERIC_SENSOR_STATE,
+					(uint8_t *)&data, sizeof(data));
+}
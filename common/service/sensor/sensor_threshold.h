@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SENSOR_THRESHOLD_H
+#define SENSOR_THRESHOLD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SENSOR_THRESHOLD_EVENT_QUEUE_SIZE_DEFAULT 16
+
+/* IPMI threshold based event offsets, table 42-2 of IPMI spec */
+enum IPMI_THRESHOLD_EVENT_OFFSET {
+	IPMI_THRESHOLD_LNC_GOING_LOW = 0x00,
+	IPMI_THRESHOLD_LCR_GOING_LOW = 0x02,
+	IPMI_THRESHOLD_LNR_GOING_LOW = 0x04,
+	IPMI_THRESHOLD_UNC_GOING_HIGH = 0x07,
+	IPMI_THRESHOLD_UCR_GOING_HIGH = 0x09,
+	IPMI_THRESHOLD_UNR_GOING_HIGH = 0x0B,
+};
+
+#define IPMI_THRESHOLD_EVENT_TYPE 0x01
+#define IPMI_EVENT_DIR_DEASSERT (1 << 7)
+/* event data 2/3 hold trigger reading and trigger threshold value */
+#define IPMI_THRESHOLD_EVENT_DATA1 0x50
+
+typedef struct _sensor_threshold_event {
+	uint8_t sensor_num;
+	uint8_t threshold; // THRESHOLD_UNR ~ THRESHOLD_LNC in sdr.h
+	bool is_assert;
+	uint8_t raw_reading; // IPMI raw reading which triggered the event
+	uint8_t raw_threshold;
+	/* threshold status before and after the event, same bit layout as byte 3 of the
+	 * get sensor reading response (bit 0 LNC ~ bit 5 UNR)
+	 */
+	uint8_t previous_status;
+	uint8_t status;
+} sensor_threshold_event;
+
+void sensor_threshold_check(uint8_t sensor_num, int *reading);
+void sensor_threshold_clear(uint8_t sensor_num);
+uint8_t get_sensor_threshold_status(uint8_t sensor_num);
+bool sensor_threshold_add_sel(uint8_t InF_target, const sensor_threshold_event *event);
+uint8_t sensor_threshold_send_pldm_event(uint16_t sensor_id, const sensor_threshold_event *event);
+void pal_sensor_threshold_event(const sensor_threshold_event *event);
+
+#endif
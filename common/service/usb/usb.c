@@ -20,7 +20,11 @@
 #include <logging/log.h>
 #include <sys/ring_buffer.h>
 #include "ipmi.h"
+#include "oem_1s_handler.h"
 #include "usb.h"
+#include "hal_gpio.h"
+#include "util_spi.h"
+#include "util_sys.h"
 #include "plat_def.h"
 
 #include <logging/log.h>
@@ -37,16 +41,301 @@ static const struct device *dev;
 struct k_thread usb_thread;
 K_KERNEL_STACK_MEMBER(usb_handler_stack, USB_HANDLER_STACK_SIZE);
 
-static inline void try_ipmi_message(ipmi_msg_cfg *current_msg, int retry)
+typedef struct _usb_fw_stream_chunk {
+	uint8_t *buf; // NULL if the stream is aborted before the chunk is filled
+	uint32_t offset;
+	uint32_t len;
+	uint8_t flash_position;
+	bool is_last;
+	bool is_abort;
+} usb_fw_stream_chunk;
+
+typedef struct _usb_fw_stream_result {
+	uint8_t completion_code;
+	uint32_t written;
+} usb_fw_stream_result;
+
+/* Only used by usb_handler, the flash writer gets everything it needs from the chunks and
+ * reports back through fw_stream_result_msgq.
+ */
+static struct {
+	bool is_active;
+	uint8_t target;
+	uint8_t flash_position;
+	uint32_t offset; // flash offset of the chunk being filled
+	uint32_t remain; // image bytes not received yet
+	uint8_t *fill_buf;
+	uint32_t fill_len;
+	bool is_discard; // drop what is left of an aborted stream
+	uint32_t discard_len;
+} fw_stream;
+
+static uint8_t fw_stream_buf[USB_FW_STREAM_CHUNK_NUM][USB_FW_STREAM_CHUNK_SIZE];
+K_MSGQ_DEFINE(fw_stream_free_msgq, sizeof(uint8_t *), USB_FW_STREAM_CHUNK_NUM, 4);
+K_MSGQ_DEFINE(fw_stream_chunk_msgq, sizeof(usb_fw_stream_chunk), USB_FW_STREAM_CHUNK_NUM + 1, 4);
+K_MSGQ_DEFINE(fw_stream_result_msgq, sizeof(usb_fw_stream_result), 1, 4);
+
+struct k_thread usb_fw_stream_thread;
+K_KERNEL_STACK_MEMBER(usb_fw_stream_stack, USB_FW_STREAM_STACK_SIZE);
+
+static inline void try_ipmi_message(ipmi_msg_cfg *current_msg)
 {
 	if (current_msg == NULL) {
 		return;
 	}
 
-	for (/*retry*/; k_msgq_put(&ipmi_msgq, current_msg, K_NO_WAIT) != 0 && retry >= 0;
-	     retry--) {
-		k_msgq_purge(&ipmi_msgq);
-		LOG_ERR("USB retrying put ipmi msgq");
+	if (ipmi_msgq_put(current_msg, K_NO_WAIT) != 0) {
+		LOG_ERR("USB put ipmi msgq fail, netfn 0x%x cmd 0x%x", current_msg->buffer.netfn,
+			current_msg->buffer.cmd);
+	}
+}
+
+static void usb_write_fw_stream_resp(uint8_t completion_code, uint32_t written)
+{
+	uint8_t tx_buf[USB_FW_STREAM_RESP_LEN];
+	struct ipmi_response *resp = (struct ipmi_response *)tx_buf;
+
+	resp->netfn = (NETFN_OEM_1S_REQ + 1) << 2;
+	resp->cmd = CMD_OEM_1S_FW_UPDATE_STREAM;
+	resp->cmplt_code = completion_code;
+	if (completion_code != CC_SUCCESS) {
+		uart_fifo_fill(dev, tx_buf, 3);
+		return;
+	}
+
+	resp->data[0] = IANA_ID & 0xFF;
+	resp->data[1] = (IANA_ID >> 8) & 0xFF;
+	resp->data[2] = (IANA_ID >> 16) & 0xFF;
+	resp->data[3] = written & 0xFF;
+	resp->data[4] = (written >> 8) & 0xFF;
+	resp->data[5] = (written >> 16) & 0xFF;
+	resp->data[6] = (written >> 24) & 0xFF;
+	uart_fifo_fill(dev, tx_buf, sizeof(tx_buf));
+}
+
+/* Start a streaming firmware update, the image data follows the request as raw USB data instead
+ * of CMD_OEM_1S_FW_UPDATE commands and is written to flash while it is received. BIC responds
+ * to the request once to accept it, and once more after the whole image is written or the
+ * stream is aborted because no data came for USB_FW_STREAM_TIMEOUT_MS.
+ */
+static void usb_fw_stream_start(uint8_t *data, int data_len)
+{
+	/*********************************
+	* Request Data
+	*
+	* Byte   0-2: IANA
+	* Byte     3: fw update target
+	* Byte   4-7: flash offset, lsb first, USB_FW_STREAM_CHUNK_SIZE aligned
+	* Byte  8-11: image length, lsb first
+	***********************************/
+	uint8_t completion_code = CC_SUCCESS;
+	uint32_t max_offset = 0;
+	int pos = -1;
+
+	if (fw_stream.is_active) {
+		completion_code = CC_NODE_BUSY;
+		goto resp;
+	}
+
+	if (data_len != USB_FW_STREAM_REQ_LEN) {
+		completion_code = CC_INVALID_LENGTH;
+		goto resp;
+	}
+
+	if (((data[2] << 16) | (data[1] << 8) | data[0]) != IANA_ID) {
+		completion_code = CC_INVALID_IANA;
+		goto resp;
+	}
+
+	uint8_t target = data[3];
+	uint32_t offset = (data[7] << 24) | (data[6] << 16) | (data[5] << 8) | data[4];
+	uint32_t length = (data[11] << 24) | (data[10] << 16) | (data[9] << 8) | data[8];
+
+	switch (target) {
+	case BIOS_UPDATE:
+		max_offset = BIOS_UPDATE_MAX_OFFSET;
+		pos = pal_get_bios_flash_position();
+		break;
+	case BIC_UPDATE:
+		max_offset = BIC_UPDATE_MAX_OFFSET;
+		pos = DEVSPI_FMC_CS0;
+		break;
+	case PRoT_FLASH_UPDATE:
+		max_offset = BIOS_UPDATE_MAX_OFFSET;
+		pos = pal_get_prot_flash_position();
+		break;
+	default:
+		completion_code = CC_INVALID_DATA_FIELD;
+		goto resp;
+	}
+
+	if ((length == 0) || (offset % USB_FW_STREAM_CHUNK_SIZE) || (offset > max_offset) ||
+	    (length - 1 > max_offset - offset)) {
+		completion_code = CC_PARAM_OUT_OF_RANGE;
+		goto resp;
+	}
+
+	if (pos == -1) {
+		completion_code = CC_INVALID_PARAM;
+		goto resp;
+	}
+
+	// Switch GPIO(BIOS SPI Selection Pin) to BIC until the whole image is written
+	if ((target == BIOS_UPDATE) && !pal_switch_bios_spi_mux(GPIO_HIGH)) {
+		completion_code = CC_UNSPECIFIED_ERROR;
+		goto resp;
+	}
+
+	fw_stream.target = target;
+	fw_stream.flash_position = pos;
+	fw_stream.offset = offset;
+	fw_stream.remain = length;
+	fw_stream.fill_buf = NULL;
+	fw_stream.fill_len = 0;
+	fw_stream.is_active = true;
+	LOG_INF("Firmware (0x%02X) stream update start, offset 0x%x length %u", target, offset,
+		length);
+
+resp:
+	usb_write_fw_stream_resp(completion_code, 0);
+}
+
+/* Hand image data to the flash writer in chunks. Blocks while all chunk buffers are being
+ * written, the USB RX ring then fills up and RX is paused so the host side backs off.
+ */
+static void usb_fw_stream_data(uint8_t *rx_buff, int rx_len)
+{
+	while ((rx_len > 0) && (fw_stream.remain > 0)) {
+		if (fw_stream.fill_buf == NULL) {
+			k_msgq_get(&fw_stream_free_msgq, &fw_stream.fill_buf, K_FOREVER);
+			fw_stream.fill_len = 0;
+		}
+
+		uint32_t copy_len = MIN(rx_len, USB_FW_STREAM_CHUNK_SIZE - fw_stream.fill_len);
+		copy_len = MIN(copy_len, fw_stream.remain);
+		memcpy(&fw_stream.fill_buf[fw_stream.fill_len], rx_buff, copy_len);
+		fw_stream.fill_len += copy_len;
+		fw_stream.remain -= copy_len;
+		rx_buff += copy_len;
+		rx_len -= copy_len;
+
+		if ((fw_stream.fill_len == USB_FW_STREAM_CHUNK_SIZE) || (fw_stream.remain == 0)) {
+			usb_fw_stream_chunk chunk = {
+				.buf = fw_stream.fill_buf,
+				.offset = fw_stream.offset,
+				.len = fw_stream.fill_len,
+				.flash_position = fw_stream.flash_position,
+				.is_last = (fw_stream.remain == 0),
+			};
+			k_msgq_put(&fw_stream_chunk_msgq, &chunk, K_FOREVER);
+			fw_stream.offset += fw_stream.fill_len;
+			fw_stream.fill_buf = NULL;
+		}
+	}
+
+	if (rx_len > 0) {
+		LOG_WRN("Drop %d bytes after the end of firmware stream", rx_len);
+	}
+}
+
+/* Host stopped sending image data, let the writer finish the queued chunks and report */
+static void usb_fw_stream_abort(void)
+{
+	LOG_ERR("Firmware (0x%02X) stream timed out, %u bytes not received", fw_stream.target,
+		fw_stream.remain);
+
+	if (fw_stream.fill_buf != NULL) {
+		k_msgq_put(&fw_stream_free_msgq, &fw_stream.fill_buf, K_NO_WAIT);
+		fw_stream.fill_buf = NULL;
+	}
+	fw_stream.remain = 0;
+	fw_stream.is_discard = true;
+	fw_stream.discard_len = 0;
+
+	usb_fw_stream_chunk chunk = {
+		.buf = NULL,
+		.is_last = true,
+		.is_abort = true,
+	};
+	k_msgq_put(&fw_stream_chunk_msgq, &chunk, K_FOREVER);
+}
+
+/* The host started a new stream or has been quiet for USB_FW_STREAM_DISCARD_IDLE_MS, data
+ * after this is parsed as IPMI commands again
+ */
+static void usb_fw_stream_discard_end(void)
+{
+	if (fw_stream.discard_len) {
+		LOG_WRN("Drop %u bytes left from aborted firmware stream", fw_stream.discard_len);
+	}
+	fw_stream.is_discard = false;
+	fw_stream.discard_len = 0;
+}
+
+static void usb_fw_stream_finish(usb_fw_stream_result *result)
+{
+	// Switch GPIO(BIOS SPI Selection Pin) to PCH
+	if ((fw_stream.target == BIOS_UPDATE) && !pal_switch_bios_spi_mux(GPIO_LOW)) {
+		result->completion_code = CC_UNSPECIFIED_ERROR;
+	}
+
+	if (result->completion_code != CC_SUCCESS) {
+		LOG_ERR("firmware (0x%02X) stream update failed cc: %x, written %u",
+			fw_stream.target, result->completion_code, result->written);
+	} else {
+		LOG_INF("Firmware (0x%02X) stream update success, written %u", fw_stream.target,
+			result->written);
+	}
+
+	usb_write_fw_stream_resp(result->completion_code, result->written);
+	fw_stream.is_active = false;
+
+	if ((result->completion_code == CC_SUCCESS) && (fw_stream.target == BIC_UPDATE)) {
+		submit_bic_warm_reset();
+	}
+}
+
+/* Flash writer, writes one chunk while the USB handler fills the other */
+static void usb_fw_stream_handler(void *arug0, void *arug1, void *arug2)
+{
+	ARG_UNUSED(arug0);
+	ARG_UNUSED(arug1);
+	ARG_UNUSED(arug2);
+
+	usb_fw_stream_chunk chunk;
+	usb_fw_stream_result result = { .completion_code = CC_SUCCESS, .written = 0 };
+	int ret;
+
+	while (1) {
+		k_msgq_get(&fw_stream_chunk_msgq, &chunk, K_FOREVER);
+
+		if (chunk.is_abort) {
+			result.completion_code = CC_TIMEOUT;
+		}
+
+		// keep draining the stream after a failure, the result is reported at the end
+		if ((chunk.buf != NULL) && (result.completion_code == CC_SUCCESS)) {
+			ret = fw_update_write(chunk.offset, chunk.buf, chunk.len,
+					      chunk.flash_position);
+			if (ret) {
+				LOG_ERR("Failed to write firmware stream at 0x%x, ret %d",
+					chunk.offset, ret);
+				result.completion_code = CC_UNSPECIFIED_ERROR;
+			} else {
+				result.written += chunk.len;
+			}
+		}
+		if (chunk.buf != NULL) {
+			k_msgq_put(&fw_stream_free_msgq, &chunk.buf, K_NO_WAIT);
+		}
+
+		if (chunk.is_last) {
+			// usb_handler restores the SPI mux and responds to the host
+			k_msgq_put(&fw_stream_result_msgq, &result, K_FOREVER);
+			k_sem_give(&usbhandle_sem);
+			result.completion_code = CC_SUCCESS;
+			result.written = 0;
+		}
 	}
 }
 
@@ -62,6 +351,24 @@ void handle_usb_data(uint8_t *rx_buff, int rx_len)
 	static uint16_t keep_data_len = 0;
 	static uint16_t fwupdate_data_len = 0;
 
+	if (fw_stream.remain > 0) {
+		usb_fw_stream_data(rx_buff, rx_len);
+		return;
+	}
+
+	bool is_stream_start = (rx_len >= SIZE_NETFN_CMD) &&
+			       (rx_buff[0] == (NETFN_OEM_1S_REQ << 2)) &&
+			       (rx_buff[1] == CMD_OEM_1S_FW_UPDATE_STREAM);
+
+	// the rest of an aborted image would otherwise be parsed as commands
+	if (fw_stream.is_discard) {
+		if (!is_stream_start || (rx_len != SIZE_NETFN_CMD + USB_FW_STREAM_REQ_LEN)) {
+			fw_stream.discard_len += rx_len;
+			return;
+		}
+		usb_fw_stream_discard_end();
+	}
+
 	if (DEBUG_USB) {
 		LOG_DBG("USB: len %d, req: %x %x ID: %x %x %x target: %x offset: %x %x %x %x len: %x %x",
 		       rx_len,
@@ -70,6 +377,11 @@ void handle_usb_data(uint8_t *rx_buff, int rx_len)
 		       rx_buff[8], rx_buff[9], rx_buff[10], rx_buff[11]);
 	}
 
+	if (is_stream_start) {
+		usb_fw_stream_start(&rx_buff[SIZE_NETFN_CMD], rx_len - SIZE_NETFN_CMD);
+		return;
+	}
+
 	// USB driver must receive 64 byte package from bmc
 	// it takes 512 + 64 byte package to receive ipmi command + 512 byte image data
 	// if cmd fw_update, record next usb package as image until receive complete data
@@ -100,7 +412,7 @@ void handle_usb_data(uint8_t *rx_buff, int rx_len)
 			keep_data_len += rx_len;
 		}
 		if (keep_data_len == fwupdate_data_len) {
-			try_ipmi_message(&current_msg, 3);
+			try_ipmi_message(&current_msg);
 			keep_data_len = 0;
 			fwupdate_data_len = 0;
 			fwupdate_keep_data = false;
@@ -111,7 +423,7 @@ void handle_usb_data(uint8_t *rx_buff, int rx_len)
 		current_msg.buffer.InF_source = BMC_USB;
 		current_msg.buffer.data_len = rx_len - SIZE_NETFN_CMD;
 		memcpy(&current_msg.buffer.data[0], &rx_buff[2], current_msg.buffer.data_len);
-		try_ipmi_message(&current_msg, 3);
+		try_ipmi_message(&current_msg);
 	}
 
 	return;
@@ -145,12 +457,34 @@ static void usb_handler(void *arug0, void *arug1, void *arug2)
 	ARG_UNUSED(arug2);
 
 	uint8_t rx_buff[RX_BUFF_SIZE];
+	usb_fw_stream_result result;
 	int rx_len;
 	int i;
 
 	while (1) {
-		k_sem_take(&usbhandle_sem, K_FOREVER);
+		// abort a firmware stream if the host stops sending image data
+		k_timeout_t timeout = K_FOREVER;
+		if (fw_stream.remain > 0) {
+			timeout = K_MSEC(USB_FW_STREAM_TIMEOUT_MS);
+		} else if (fw_stream.is_discard) {
+			timeout = K_MSEC(USB_FW_STREAM_DISCARD_IDLE_MS);
+		}
+		if (k_sem_take(&usbhandle_sem, timeout) != 0) {
+			if (fw_stream.remain > 0) {
+				usb_fw_stream_abort();
+			} else {
+				usb_fw_stream_discard_end();
+			}
+			continue;
+		}
+
+		if (k_msgq_get(&fw_stream_result_msgq, &result, K_NO_WAIT) == 0) {
+			usb_fw_stream_finish(&result);
+		}
+
 		rx_len = ring_buf_get(&ringbuf, rx_buff, sizeof(rx_buff));
+		// resume RX if the interrupt handler paused it on a full ring
+		uart_irq_rx_enable(dev);
 		if (!rx_len) {
 			k_msleep(10);
 			continue;
@@ -173,6 +507,13 @@ static void interrupt_handler(const struct device *dev, void *user_data)
 	ARG_UNUSED(user_data);
 
 	while (uart_irq_is_pending(dev) && uart_irq_rx_ready(dev)) {
+		if (ring_buf_space_get(&ringbuf) < sizeof(rx_buff)) {
+			// leave data in the CDC ACM FIFO until usb_handler drains the ring, so the
+			// host is flow controlled instead of data being dropped
+			uart_irq_rx_disable(dev);
+			break;
+		}
+
 		recv_len = uart_fifo_read(dev, rx_buff, sizeof(rx_buff));
 
 		if (recv_len) {
@@ -211,6 +552,15 @@ void usb_dev_init(void)
 			usb_handler, NULL, NULL, NULL, CONFIG_MAIN_THREAD_PRIORITY, 0, K_NO_WAIT);
 	k_thread_name_set(&usb_thread, "USB_handler");
 
+	for (uint8_t i = 0; i < USB_FW_STREAM_CHUNK_NUM; i++) {
+		uint8_t *buf = fw_stream_buf[i];
+		k_msgq_put(&fw_stream_free_msgq, &buf, K_NO_WAIT);
+	}
+	k_thread_create(&usb_fw_stream_thread, usb_fw_stream_stack,
+			K_THREAD_STACK_SIZEOF(usb_fw_stream_stack), usb_fw_stream_handler, NULL,
+			NULL, NULL, CONFIG_MAIN_THREAD_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&usb_fw_stream_thread, "USB_fw_stream");
+
 	uint8_t init_sem_count = RING_BUF_SIZE / RX_BUFF_SIZE;
 	k_sem_init(&usbhandle_sem, 0, init_sem_count);
 }
@@ -27,6 +27,17 @@
 #define FWUPDATE_HEADER_SIZE 12
 #define SIZE_NETFN_CMD 2
 
+/* Streaming firmware update, image data is collected in USB_FW_STREAM_CHUNK_NUM buffers of
+ * USB_FW_STREAM_CHUNK_SIZE bytes so one is written to flash while the next one is received
+ */
+#define USB_FW_STREAM_STACK_SIZE 2048
+#define USB_FW_STREAM_CHUNK_SIZE 0x1000
+#define USB_FW_STREAM_CHUNK_NUM 2
+#define USB_FW_STREAM_REQ_LEN 12 // IANA + target + offset + image length
+#define USB_FW_STREAM_RESP_LEN 10 // netfn + cmd + cc + IANA + written length
+#define USB_FW_STREAM_TIMEOUT_MS 5000 // abort the stream if no image data comes in time
+#define USB_FW_STREAM_DISCARD_IDLE_MS 2000 // data of an aborted stream ends after this idle time
+
 #include "ipmb.h"
 
 void usb_targetdev_init(void);
@@ -20,6 +20,8 @@
 #include <string.h>
 #include "ipmi.h"
 #include "ipmb.h"
+#include "ipmi_cmd_table.h"
+#include "ipmi_msg_pool.h"
 
 void cmd_ipmi_raw(const struct shell *shell, size_t argc, char **argv)
 {
@@ -42,12 +44,8 @@ void cmd_ipmi_raw(const struct shell *shell, size_t argc, char **argv)
 		msg.buffer.data[i] = strtol(argv[3 + i], NULL, 16);
 	}
 
-	int retry = 0;
-	while (k_msgq_put(&ipmi_msgq, &msg, K_NO_WAIT) != 0 && retry < 3) {
-		k_msgq_purge(&ipmi_msgq);
-		shell_error(shell, "Retry to put msg into ipmi msgq...");
-		retry++;
-	}
+	/* a busy response still comes back through self_ipmi_msgq */
+	ipmi_msgq_put(&msg, K_MSEC(1000));
 
 	if (k_msgq_get(&self_ipmi_msgq, &msg, K_MSEC(1000))) {
 		shell_error(shell, "Failed to get ipmi msgq in time");
@@ -95,9 +93,11 @@ void cmd_ipmi_list(const struct shell *shell, size_t argc, char **argv)
 			msg.buffer.data_len = ARRAY_SIZE(dummy_msg);
 			memcpy(msg.buffer.data, dummy_msg, ARRAY_SIZE(dummy_msg));
 
-			if (k_msgq_put(&ipmi_msgq, &msg, K_NO_WAIT)) {
+			if (ipmi_msgq_put(&msg, K_MSEC(1000))) {
 				shell_error(shell, "Failed to send req netfn:0x%x cmd:0x%x...",
 					    netfn_idx, cmd_idx);
+				/* drop the busy response */
+				k_msgq_purge(&self_ipmi_msgq);
 				continue;
 			}
 			if (k_msgq_get(&self_ipmi_msgq, &msg, K_MSEC(1000))) {
@@ -125,3 +125,46 @@ void cmd_ipmi_list(const struct shell *shell, size_t argc, char **argv)
 		shell,
 		"------------------------------------------------------------------------------");
 }
+
+void cmd_ipmi_stat(const struct shell *shell, size_t argc, char **argv)
+{
+	ipmi_msgq_stat stat;
+
+	shell_print(shell, "%-8s %8s %10s %10s %10s", "channel", "queued", "accepted", "rejected",
+		    "dropped");
+	for (uint8_t i = 0; get_ipmi_msgq_stat(i, &stat); i++) {
+		if (stat.channel == RESERVED) {
+			shell_print(shell, "%-8s %8u %10u %10u %10u", "other", stat.queued,
+				    stat.accepted, stat.rejected, stat.dropped);
+		} else {
+			shell_print(shell, "0x%-6x %8u %10u %10u %10u", stat.channel, stat.queued,
+				    stat.accepted, stat.rejected, stat.dropped);
+		}
+	}
+
+	ipmi_msg_pool_stat pool_stat;
+	get_ipmi_msg_pool_stat(&pool_stat);
+	shell_print(shell, "msg pool: total %u, used %u, max used %u, alloc fail %u",
+		    pool_stat.total, pool_stat.used, pool_stat.max_used, pool_stat.alloc_fail);
+}
+
+void cmd_ipmi_cmd_stat(const struct shell *shell, size_t argc, char **argv)
+{
+	ipmi_cmd_stat stat;
+
+	shell_print(shell, "%-6s %-4s %10s %8s %10s %10s %10s", "netfn", "cmd", "count", "error",
+		    "min(us)", "avg(us)", "max(us)");
+	for (uint16_t i = 0; get_ipmi_cmd_stat(i, &stat); i++) {
+		if (stat.count == 0) {
+			continue;
+		}
+		shell_print(shell, "0x%-4x 0x%-2x %10u %8u %10u %10u %10u", stat.netfn, stat.cmd,
+			    stat.count, stat.error, stat.min_us,
+			    (uint32_t)(stat.total_us / stat.count), stat.max_us);
+	}
+
+	if ((argc > 1) && !strcmp(argv[1], "clear")) {
+		clear_ipmi_cmd_stat();
+		shell_print(shell, "Statistics cleared");
+	}
+}
@@ -22,9 +22,15 @@
 
 void cmd_ipmi_list(const struct shell *shell, size_t argc, char **argv);
 void cmd_ipmi_raw(const struct shell *shell, size_t argc, char **argv);
+void cmd_ipmi_stat(const struct shell *shell, size_t argc, char **argv);
+void cmd_ipmi_cmd_stat(const struct shell *shell, size_t argc, char **argv);
 
 SHELL_STATIC_SUBCMD_SET_CREATE(
 	sub_ipmi_cmds, SHELL_CMD(scan, NULL, "Scanning all supported commands", cmd_ipmi_list),
-	SHELL_CMD(raw, NULL, "Send raw command", cmd_ipmi_raw), SHELL_SUBCMD_SET_END);
+	SHELL_CMD(raw, NULL, "Send raw command", cmd_ipmi_raw),
+	SHELL_CMD(stat, NULL, "Show IPMI message queue and pool statistics", cmd_ipmi_stat),
+	SHELL_CMD(cmdstat, NULL, "Show IPMI command execution statistics, [clear] to reset",
+		  cmd_ipmi_cmd_stat),
+	SHELL_SUBCMD_SET_END);
 
 #endif
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mctp_shell.h"
+#include <zephyr.h>
+#include "mctp_pending.h"
+
+void cmd_mctp_pending_stat(const struct shell *shell, size_t argc, char **argv)
+{
+	mctp_pending_stat stat;
+
+	shell_print(shell, "%-18s %8s %8s %8s %8s %10s %8s %8s", "table", "sent", "resp", "timeout",
+		    "no slot", "unexpected", "avg(ms)", "max(ms)");
+	for (uint8_t i = 0; mctp_pending_get_stat(i, &stat); i++) {
+		shell_print(shell, "%-18s %8u %8u %8u %8u %10u %8u %8u", stat.name, stat.sent,
+			    stat.resp, stat.timeout, stat.no_slot, stat.unexpected,
+			    stat.resp ? (stat.total_latency_ms / stat.resp) : 0, stat.max_latency_ms);
+	}
+}
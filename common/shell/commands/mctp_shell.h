@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MCTP_SHELL_H
+#define MCTP_SHELL_H
+
+#include <stdlib.h>
+#include <shell/shell.h>
+
+void cmd_mctp_pending_stat(const struct shell *shell, size_t argc, char **argv);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_mctp_cmds,
+			       SHELL_CMD(pending, NULL,
+					 "Show statistics of requests waiting for response",
+					 cmd_mctp_pending_stat),
+			       SHELL_SUBCMD_SET_END);
+
+#endif
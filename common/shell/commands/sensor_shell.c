@@ -63,23 +63,24 @@ static bool sensor_access_check(uint8_t sensor_num)
 
 static int sensor_get_idx_by_sensor_num(uint16_t sensor_num)
 {
-	for (int sen_idx = 0; sen_idx < sensor_config_count; sen_idx++) {
-		if (sensor_num == sensor_config[sen_idx].num)
-			return sen_idx;
-	}
+	if (sensor_num >= SENSOR_NUM_MAX)
+		return -1;
 
-	return -1;
+	uint8_t sen_idx = get_sensor_config_index(sensor_num);
+	if (sen_idx == SENSOR_NUM_MAX)
+		return -1;
+
+	return sen_idx;
 }
 
 static int get_sdr_index_by_sensor_num(uint8_t sensor_num)
 {
-	for (int index = 0; index < sdr_count; ++index) {
-		if (sensor_num == full_sdr_table[index].sensor_num) {
-			return index;
-		}
+	int index = get_sdr_index(sensor_num);
+	if ((index < 0) || (index == SENSOR_NUM_MAX)) {
+		return -1;
 	}
 
-	return -1;
+	return index;
 }
 
 static int sensor_access(const struct shell *shell, int sensor_num, enum SENSOR_ACCESS mode)
@@ -261,3 +262,33 @@ void cmd_control_sensor_polling(const struct shell *shell, size_t argc, char **a
 		    ((operation == DISABLE_SENSOR_POLLING) ? "disable" : "enable"));
 	return;
 }
+
+void cmd_sensor_poll_stat(const struct shell *shell, size_t argc, char **argv)
+{
+	if (argc != 1) {
+		shell_warn(shell, "Help: platform sensor poll_stat");
+		return;
+	}
+
+	sensor_poll_bus_stat stat[SENSOR_POLL_BUS_MAX];
+	int64_t scan_time_ms = 0, max_scan_time_ms = 0;
+	uint8_t count = get_sensor_poll_bus_stat(stat, ARRAY_SIZE(stat));
+
+	get_sensor_poll_scan_time(&scan_time_ms, &max_scan_time_ms);
+	shell_print(shell, "Full scan time: %lld ms, max: %lld ms", scan_time_ms,
+		    max_scan_time_ms);
+	shell_print(
+		shell,
+		"---------------------------------------------------------------------------------");
+	for (uint8_t i = 0; i < count; i++) {
+		shell_print(shell,
+			    "%-4s %-10s %3d | thread[%d] | sensors %3d | scan %5lld ms | max %5lld ms",
+			    (stat[i].is_i2c_bus ? "bus" : "type"),
+			    (stat[i].is_i2c_bus ? "" : sensor_type_name[stat[i].bus]), stat[i].bus,
+			    stat[i].worker, stat[i].sensor_count, stat[i].scan_time_ms,
+			    stat[i].max_scan_time_ms);
+	}
+	shell_print(
+		shell,
+		"---------------------------------------------------------------------------------");
+}
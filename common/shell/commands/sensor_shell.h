@@ -27,6 +27,7 @@ enum SENSOR_ACCESS { SENSOR_READ, SENSOR_WRITE };
 void cmd_sensor_cfg_list_all(const struct shell *shell, size_t argc, char **argv);
 void cmd_sensor_cfg_get(const struct shell *shell, size_t argc, char **argv);
 void cmd_control_sensor_polling(const struct shell *shell, size_t argc, char **argv);
+void cmd_sensor_poll_stat(const struct shell *shell, size_t argc, char **argv);
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_sensor_cmds,
 			       SHELL_CMD(list_all, NULL, "List all SENSOR config.",
@@ -35,6 +36,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_sensor_cmds,
 			       SHELL_CMD(control_sensor_polling, NULL,
 					 "Enable/Disable sensor polling",
 					 cmd_control_sensor_polling),
+			       SHELL_CMD(poll_stat, NULL, "Get sensor polling scan time per bus",
+					 cmd_sensor_poll_stat),
 			       SHELL_SUBCMD_SET_END);
 
 #endif
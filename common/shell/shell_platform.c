@@ -20,6 +20,7 @@
 #include "commands/flash_shell.h"
 #include "commands/ipmi_shell.h"
 #include "commands/power_shell.h"
+#include "commands/mctp_shell.h"
 
 /* MAIN command */
 SHELL_STATIC_SUBCMD_SET_CREATE(
@@ -28,6 +29,7 @@ SHELL_STATIC_SUBCMD_SET_CREATE(
 	SHELL_CMD(sensor, &sub_sensor_cmds, "SENSOR relative command.", NULL),
 	SHELL_CMD(flash, &sub_flash_cmds, "FLASH(spi) relative command.", NULL),
 	SHELL_CMD(ipmi, &sub_ipmi_cmds, "IPMI relative command.", NULL),
-	SHELL_CMD(power, &sub_power_cmds, "POWER relative command.", NULL), SHELL_SUBCMD_SET_END);
+	SHELL_CMD(power, &sub_power_cmds, "POWER relative command.", NULL),
+	SHELL_CMD(mctp, &sub_mctp_cmds, "MCTP relative command.", NULL), SHELL_SUBCMD_SET_END);
 
 SHELL_CMD_REGISTER(platform, &sub_platform_cmds, "Platform commands", NULL);
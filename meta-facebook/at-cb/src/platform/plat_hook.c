@@ -20,6 +20,7 @@
 #include <logging/log.h>
 #include "sensor.h"
 #include "pmbus.h"
+#include "util_pmbus.h"
 #include "libutil.h"
 #include "plat_i2c.h"
 #include "power_status.h"
@@ -141,7 +142,6 @@ bool pre_xdpe15284_read(uint8_t sensor_num, void *args)
 	bool ret = false;
 	int retry = 3;
 	int mutex_status = 0;
-	I2C_MSG msg = { 0 };
 	vr_page_cfg *xdpe15284_page = (vr_page_cfg *)args;
 
 	mutex_status = k_mutex_lock(&xdpe15284_mutex, K_MSEC(MUTEX_LOCK_INTERVAL_MS));
@@ -150,13 +150,10 @@ bool pre_xdpe15284_read(uint8_t sensor_num, void *args)
 		return false;
 	}
 
-	msg.bus = sensor_config[sensor_config_index_map[sensor_num]].port;
-	msg.target_addr = sensor_config[sensor_config_index_map[sensor_num]].target_addr;
-	msg.tx_len = 2;
-	msg.data[0] = PMBUS_PAGE;
-	msg.data[1] = xdpe15284_page->vr_page;
-
-	ret = i2c_master_write(&msg, retry);
+	// Skipped if the VR is on the page already
+	ret = i2c_master_write_page(sensor_config[sensor_config_index_map[sensor_num]].port,
+				    sensor_config[sensor_config_index_map[sensor_num]].target_addr,
+				    xdpe15284_page->vr_page, retry);
 	if (ret != 0) {
 		LOG_ERR("Set xdpe15284 page fail, ret: %d", ret);
 		return false;
@@ -179,6 +176,12 @@ bool post_xdpe15284_read(uint8_t sensor_num, void *args, int *reading)
 	return true;
 }
 
+bool pal_is_pmbus_batch_post_hook(bool (*post_hook)(uint8_t, void *, int *))
+{
+	/* post_xdpe15284_read only releases the mutex taken by pre_xdpe15284_read */
+	return (post_hook == post_xdpe15284_read);
+}
+
 bool pre_pex89000_read(uint8_t sensor_num, void *args)
 {
 	CHECK_NULL_ARG_WITH_RETURN(args, false);
@@ -25,6 +25,7 @@
 #include "i2c-mux-tca9548.h"
 #include "pex89000.h"
 #include "pmbus.h"
+#include "util_pmbus.h"
 
 #include <logging/log.h>
 
@@ -878,20 +879,16 @@ bool pre_vr_read(uint8_t sensor_num, void *args)
 	}
 	vr_pre_proc_arg *pre_proc_args = (vr_pre_proc_arg *)args;
 	uint8_t retry = 5;
-	I2C_MSG msg = { 0 };
 
 	if (!pre_i2c_bus_read(sensor_num, pre_proc_args->mux_info_p)) {
 		LOG_ERR("pre_i2c_bus_read fail");
 		return false;
 	}
 
-	/* set page */
-	msg.bus = sensor_config[sensor_config_index_map[sensor_num]].port;
-	msg.target_addr = sensor_config[sensor_config_index_map[sensor_num]].target_addr;
-	msg.tx_len = 2;
-	msg.data[0] = 0x00;
-	msg.data[1] = pre_proc_args->vr_page;
-	if (i2c_master_write(&msg, retry)) {
+	/* set page, skipped if the VR is on the page already */
+	if (i2c_master_write_page(sensor_config[sensor_config_index_map[sensor_num]].port,
+				  sensor_config[sensor_config_index_map[sensor_num]].target_addr,
+				  pre_proc_args->vr_page, retry)) {
 		LOG_ERR("Set page fail");
 		k_mutex_unlock(&i2c_bus6_mutex);
 		return false;
@@ -960,6 +957,7 @@ bool post_i2c_bus_read(uint8_t sensor_num, void *args, int *reading)
        * Because BUS9 has two mux behind 16 E1.S with the same i2c address, 
        * so close all mux channels after the sensor read to avoid conflict with 
        * other devices reading.
+       * The raw write also drops the cached mux/page state of the bus.
        */
 			I2C_MSG msg = { 0 };
 			uint8_t retry = 5;
@@ -982,6 +980,12 @@ bool post_i2c_bus_read(uint8_t sensor_num, void *args, int *reading)
 	return true;
 }
 
+bool pal_is_pmbus_batch_post_hook(bool (*post_hook)(uint8_t, void *, int *))
+{
+	/* post_i2c_bus_read only releases the bus taken by pre_i2c_bus_read */
+	return (post_hook == post_i2c_bus_read);
+}
+
 bool post_mp5990_read(uint8_t sensor_num, void *args, int *reading)
 {
 	if (!reading) {
@@ -26,6 +26,7 @@
 #include "plat_sensor_table.h"
 #include "oem_1s_handler.h"
 #include "hal_gpio.h"
+#include "hal_i2c.h"
 #include "util_sys.h"
 #include "pex89000.h"
 #include "pldm.h"
@@ -98,6 +99,8 @@ void dc_on_send_cmd_to_dev()
 void ISR_DC_ON()
 {
 	LOG_INF("System is DC %s", is_mb_dc_on() ? "on" : "off");
+	// Muxes and VRs on DC power come back with their default channel and page
+	i2c_select_cache_invalidate_all();
 	/* Check whether DC on to send work to initial PEX */
 	if (is_mb_dc_on()) {
 		k_work_schedule(&dc_on_send_cmd_to_dev_work, K_SECONDS(DC_ON_5_SECOND));
@@ -35,11 +35,6 @@
 
 LOG_MODULE_REGISTER(plat_sensor_table);
 
-sensor_poll_time_cfg diff_poll_time_sensor_table[] = {
-	// sensor_number, last_access_time
-	{ SENSOR_NUM_VOL_BAT3V, 0 },
-};
-
 dimm_pmic_mapping_cfg dimm_pmic_map_table[] = {
 	// dimm_sensor_num, mapping_pmic_sensor_num
 	{ SENSOR_NUM_TEMP_DIMM_A, SENSOR_NUM_PWR_DIMMA_PMIC },
@@ -355,30 +350,6 @@ void pal_extend_sensor_config()
 	}
 }
 
-bool pal_is_time_to_poll(uint8_t sensor_num, int poll_time)
-{
-	int i = 0;
-	int table_size = sizeof(diff_poll_time_sensor_table) / sizeof(sensor_poll_time_cfg);
-
-	for (i = 0; i < table_size; i++) {
-		if (sensor_num == diff_poll_time_sensor_table[i].sensor_num) {
-			int64_t current_access_time = k_uptime_get();
-			int64_t last_access_time = diff_poll_time_sensor_table[i].last_access_time;
-			int64_t diff_time = (current_access_time - last_access_time) / 1000;
-			if ((last_access_time != 0) && (diff_time < poll_time)) {
-				return false;
-			} else {
-				diff_poll_time_sensor_table[i].last_access_time =
-					current_access_time;
-				return true;
-			}
-		}
-	}
-
-	LOG_WRN("Can't find sensor 0x%x last access time", sensor_num);
-	return true;
-}
-
 uint8_t get_hsc_pwr_reading(int *reading)
 {
 	CHECK_NULL_ARG_WITH_RETURN(reading, SENSOR_UNSPECIFIED_ERROR);
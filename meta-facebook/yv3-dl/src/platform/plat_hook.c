@@ -202,21 +202,16 @@ bool pre_vr_read(uint8_t sensor_num, void *args)
 
 	vr_pre_proc_arg *vr_page_sel = (vr_pre_proc_arg *)args;
 	uint8_t retry = 5;
-	I2C_MSG msg;
 
 	if (k_mutex_lock(&vr_page_mutex, K_MSEC(VR_PAGE_MUTEX_TIMEOUT_MS))) {
 		LOG_ERR("Failed to lock vr page");
 		return false;
 	}
 
-	/* set page */
-	msg.bus = sensor_config[sensor_config_index_map[sensor_num]].port;
-	msg.target_addr = sensor_config[sensor_config_index_map[sensor_num]].target_addr;
-	msg.tx_len = 2;
-	msg.data[0] = 0x00;
-	msg.data[1] = vr_page_sel->vr_page;
-
-	if (i2c_master_write(&msg, retry)) {
+	/* set page, skipped if the VR is on the page already */
+	if (i2c_master_write_page(sensor_config[sensor_config_index_map[sensor_num]].port,
+				  sensor_config[sensor_config_index_map[sensor_num]].target_addr,
+				  vr_page_sel->vr_page, retry)) {
 		LOG_ERR("Set page fail");
 		if (k_mutex_unlock(&vr_page_mutex)) {
 			LOG_ERR("Failed to unlock vr page");
@@ -138,15 +138,11 @@ bool pre_isl69259_read(uint8_t sensor_num, void *args)
 
 	isl69259_pre_proc_arg *pre_proc_args = (isl69259_pre_proc_arg *)args;
 	uint8_t retry = 5;
-	I2C_MSG msg;
-
-	/* set page */
-	msg.bus = sensor_config[sensor_config_index_map[sensor_num]].port;
-	msg.target_addr = sensor_config[sensor_config_index_map[sensor_num]].target_addr;
-	msg.tx_len = 2;
-	msg.data[0] = 0x00;
-	msg.data[1] = pre_proc_args->vr_page;
-	if (i2c_master_write(&msg, retry)) {
+
+	/* set page, skipped if the VR is on the page already */
+	if (i2c_master_write_page(sensor_config[sensor_config_index_map[sensor_num]].port,
+				  sensor_config[sensor_config_index_map[sensor_num]].target_addr,
+				  pre_proc_args->vr_page, retry)) {
 		LOG_ERR("pre_isl69259_read, set page fail");
 		return false;
 	}
@@ -21,6 +21,7 @@
 #include <string.h>
 
 #include "sensor.h"
+#include "sensor_history.h"
 #include "ast_adc.h"
 #include "intel_peci.h"
 #include "hal_gpio.h"
@@ -42,11 +43,6 @@ LOG_MODULE_REGISTER(plat_sensor_table);
 SET_GPIO_VALUE_CFG pre_bat_3v = { A_P3V_BAT_SCALED_EN_R, GPIO_HIGH };
 SET_GPIO_VALUE_CFG post_bat_3v = { A_P3V_BAT_SCALED_EN_R, GPIO_LOW };
 
-sensor_poll_time_cfg diff_poll_time_sensor_table[] = {
-	// sensor_number, last_access_time
-	{ SENSOR_NUM_VOL_BAT3V, 0 },
-};
-
 dimm_pmic_mapping_cfg dimm_pmic_map_table[] = {
 	// dimm_sensor_num, mapping_pmic_sensor_num
 	{ SENSOR_NUM_TEMP_DIMM_A0, SENSOR_NUM_PWR_DIMMA0_PMIC },
@@ -606,33 +602,15 @@ void pal_extend_sensor_config()
 	}
 }
 
-bool pal_is_time_to_poll(uint8_t sensor_num, int poll_time)
+uint8_t get_hsc_pwr_reading(int *reading)
 {
-	int i = 0;
-	int table_size = sizeof(diff_poll_time_sensor_table) / sizeof(sensor_poll_time_cfg);
-
-	for (i = 0; i < table_size; i++) {
-		if (sensor_num == diff_poll_time_sensor_table[i].sensor_num) {
-			int64_t current_access_time = k_uptime_get();
-			int64_t last_access_time = diff_poll_time_sensor_table[i].last_access_time;
-			int64_t diff_time = (current_access_time - last_access_time) / 1000; // sec
-			if ((last_access_time != 0) && (diff_time < poll_time)) {
-				return false;
-			} else {
-				diff_poll_time_sensor_table[i].last_access_time =
-					current_access_time;
-				return true;
-			}
-		}
-	}
-
-	LOG_ERR("Cannot find sensor 0x%x last accest time", sensor_num);
-	return true;
+	return get_sensor_reading(SENSOR_NUM_PWR_HSCIN, reading, GET_FROM_CACHE);
 }
 
-uint8_t get_hsc_pwr_reading(int *reading)
+bool pal_is_sensor_history_needed(uint8_t sensor_num)
 {
-	return get_sensor_reading(SENSOR_NUM_PWR_HSCIN, reading, GET_FROM_CACHE);
+	/* keep HSC input power history for BMC peak/average power query */
+	return (sensor_num == SENSOR_NUM_PWR_HSCIN);
 }
 
 bool disable_dimm_pmic_sensor(uint8_t sensor_num)
@@ -655,13 +633,14 @@ bool disable_dimm_pmic_sensor(uint8_t sensor_num)
 
 static int sensor_get_idx_by_sensor_num(uint16_t sensor_num)
 {
-	int sensor_idx = 0;
-	for (sensor_idx = 0; sensor_idx < sensor_config_count; sensor_idx++) {
-		if (sensor_num == sensor_config[sensor_idx].num)
-			return sensor_idx;
-	}
+	if (sensor_num >= SENSOR_NUM_MAX)
+		return -1;
+
+	uint8_t sensor_idx = get_sensor_config_index(sensor_num);
+	if (sensor_idx == SENSOR_NUM_MAX)
+		return -1;
 
-	return -1;
+	return sensor_idx;
 }
 
 uint8_t get_dimm_status(uint8_t dimm_index)
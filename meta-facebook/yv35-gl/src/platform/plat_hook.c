@@ -56,15 +56,11 @@ bool pre_xdpe15284_read(uint8_t sensor_num, void *args)
 
 	xdpe15284_pre_read_arg *pre_read_args = (xdpe15284_pre_read_arg *)args;
 	uint8_t retry = 5;
-	I2C_MSG msg;
-
-	/* set page */
-	msg.bus = sensor_config[sensor_config_index_map[sensor_num]].port;
-	msg.target_addr = sensor_config[sensor_config_index_map[sensor_num]].target_addr;
-	msg.tx_len = 2;
-	msg.data[0] = 0x00;
-	msg.data[1] = pre_read_args->vr_page;
-	if (i2c_master_write(&msg, retry)) {
+
+	/* set page, skipped if the VR is on the page already */
+	if (i2c_master_write_page(sensor_config[sensor_config_index_map[sensor_num]].port,
+				  sensor_config[sensor_config_index_map[sensor_num]].target_addr,
+				  pre_read_args->vr_page, retry)) {
 		LOG_ERR("Failed to set page");
 		return false;
 	}
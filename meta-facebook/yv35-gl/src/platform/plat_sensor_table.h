@@ -41,6 +41,9 @@
 #define VR_CUR_OFFSET 0x8C
 #define VR_PWR_OFFSET 0x96
 
+/* Same as yv35-cl/yv35-hd/wc-mb. Each read enables the A_P3V_BAT_SCALED_EN_R divider, which
+ * drains the coin cell, and the battery voltage only moves over days.
+ */
 #define POLL_TIME_BAT3V 3600 // sec
 
 // Threshold sensor number definition
@@ -111,15 +111,9 @@ bool pre_vr_read(uint8_t sensor_num, void *args)
 	vr_pre_proc_arg *pre_proc_args = (vr_pre_proc_arg *)args;
 	sensor_cfg *cfg = &sensor_config[sensor_config_index_map[sensor_num]];
 	uint8_t retry = 5;
-	I2C_MSG msg;
-
-	/* set page */
-	msg.bus = cfg->port;
-	msg.target_addr = cfg->target_addr;
-	msg.tx_len = 2;
-	msg.data[0] = 0x00;
-	msg.data[1] = pre_proc_args->vr_page;
-	if (i2c_master_write(&msg, retry)) {
+
+	/* set page, skipped if the VR is on the page already */
+	if (i2c_master_write_page(cfg->port, cfg->target_addr, pre_proc_args->vr_page, retry)) {
 		LOG_ERR("Failed to set VR page, sensor_num 0x%x", sensor_num);
 		return false;
 	}
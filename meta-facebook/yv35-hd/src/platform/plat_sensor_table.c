@@ -28,11 +28,6 @@
 
 LOG_MODULE_REGISTER(plat_sensor_table);
 
-sensor_poll_time_cfg diff_poll_time_sensor_table[] = {
-	// sensor_number, last_access_time
-	{ SENSOR_NUM_VOL_P3V_BAT, 0 },
-};
-
 sensor_cfg plat_sensor_config[] = {
 	/* number, type, port, address, offset, access check, arg0, arg1, cache, cache_status,
 	   pre_sensor_read_fn, pre_sensor_read_args, post_sensor_read_fn, post_sensor_read_fn,
@@ -659,30 +654,6 @@ uint8_t pal_get_extend_sensor_config()
 	return extend_sensor_config_size;
 }
 
-bool pal_is_time_to_poll(uint8_t sensor_num, int poll_time)
-{
-	int i = 0;
-	int table_size = sizeof(diff_poll_time_sensor_table) / sizeof(sensor_poll_time_cfg);
-
-	for (i = 0; i < table_size; i++) {
-		if (sensor_num == diff_poll_time_sensor_table[i].sensor_num) {
-			int64_t current_access_time = k_uptime_get();
-			int64_t last_access_time = diff_poll_time_sensor_table[i].last_access_time;
-			int64_t diff_time = (current_access_time - last_access_time) / 1000;
-			if ((last_access_time != 0) && (diff_time < poll_time)) {
-				return false;
-			} else {
-				diff_poll_time_sensor_table[i].last_access_time =
-					current_access_time;
-				return true;
-			}
-		}
-	}
-
-	LOG_ERR("Can't find sensor 0x%x last access time", sensor_num);
-	return true;
-}
-
 const int SENSOR_CONFIG_SIZE = ARRAY_SIZE(plat_sensor_config);
 
 void load_sensor_config(void)
@@ -130,17 +130,12 @@ bool pre_vr_read(uint8_t sensor_num, void *args)
 
 	vr_pre_proc_arg *vr_page_sel = (vr_pre_proc_arg *)args;
 	uint8_t retry = 5;
-	I2C_MSG msg;
 	int ret = 0;
 
-	/* set page */
-	msg.bus = sensor_config[sensor_config_index_map[sensor_num]].port;
-	msg.target_addr = sensor_config[sensor_config_index_map[sensor_num]].target_addr;
-	msg.tx_len = 2;
-	msg.data[0] = 0x00;
-	msg.data[1] = vr_page_sel->vr_page;
-
-	ret = i2c_master_write(&msg, retry);
+	/* set page, skipped if the VR is on the page already */
+	ret = i2c_master_write_page(sensor_config[sensor_config_index_map[sensor_num]].port,
+				    sensor_config[sensor_config_index_map[sensor_num]].target_addr,
+				    vr_page_sel->vr_page, retry);
 	if (ret != 0) {
 		LOG_ERR("I2C write fail  ret: %d", ret);
 		return false;